@@ -0,0 +1,172 @@
+#pragma once
+//
+//  batchtransform.h
+//  Model matrices of many drawCube()-style objects at once
+//
+//  drawCube() composes translate, three rotates and a scale per call. For
+//  a whole array of objects, composeTransforms() does the same work in
+//  batches of 8. When none of the 8 objects is rotated (every cube of the
+//  kitchen), the matrices are computed in SoA form with AVX2, one lane per
+//  object, and transposed into glm::mat4 on the way out. Batches with a
+//  rotation, the tail and builds without AVX2 (Win32) use the per-object
+//  path; the x64 configurations of the app build with /arch:AVX2.
+//
+
+#ifndef batchtransform_h
+#define batchtransform_h
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BATCH_TRANSFORM_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BATCH_TRANSFORM_SSE
+#endif
+
+// same transform as drawCube(): translate, rotate x, y, z (degrees), then scale, below parent
+inline glm::mat4 composeTransform(const glm::mat4& parent, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+    glm::mat4 model = parent;
+    model[3] = parent[0] * position.x + parent[1] * position.y + parent[2] * position.z + parent[3];
+
+    // a zero angle rotation leaves the matrix unchanged
+    if (rotation.x != 0.0f)
+        model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    if (rotation.y != 0.0f)
+        model = glm::rotate(model, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    if (rotation.z != 0.0f)
+        model = glm::rotate(model, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    model[0] = model[0] * scale.x;
+    model[1] = model[1] * scale.y;
+    model[2] = model[2] * scale.z;
+    return model;
+}
+
+#if defined(BATCH_TRANSFORM_AVX2)
+// rows of 8 lanes in, lanes of 8 rows out
+inline void transpose8x8(__m256 rows[8])
+{
+    __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+    __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+    __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+    __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+    __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+    __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+    __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+    __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+    rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// true when any of the 8 vec3 is not all zero
+inline bool anyNonZero8(const glm::vec3* values)
+{
+    const float* v = &values[0].x;
+    __m256 zero = _mm256_setzero_ps();
+    __m256 nonZero = _mm256_or_ps(
+        _mm256_or_ps(_mm256_cmp_ps(_mm256_loadu_ps(v), zero, _CMP_NEQ_UQ), _mm256_cmp_ps(_mm256_loadu_ps(v + 8), zero, _CMP_NEQ_UQ)),
+        _mm256_cmp_ps(_mm256_loadu_ps(v + 16), zero, _CMP_NEQ_UQ));
+    return _mm256_movemask_ps(nonZero) != 0;
+}
+#endif
+
+// out[i] = composeTransform(parent, positions[i], rotations[i], scales[i]); rotations may be null for none
+inline void composeTransforms(const glm::mat4& parent, const glm::vec3* positions, const glm::vec3* rotations, const glm::vec3* scales, size_t count, glm::mat4* out)
+{
+    const glm::vec3 noRotation(0.0f);
+    size_t i = 0;
+
+#if defined(BATCH_TRANSFORM_AVX2)
+    // the parent broadcast once, element e is column e / 4, row e % 4
+    __m256 p[16];
+    for (int e = 0; e < 16; e++)
+        p[e] = _mm256_set1_ps(parent[e / 4][e % 4]);
+    // x of 8 consecutive vec3, y and z follow at +1 and +2
+    const __m256i vec3Stride = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+    for (; i + 8 <= count; i += 8) {
+        if (rotations && anyNonZero8(rotations + i)) {
+            for (size_t k = i; k < i + 8; k++)
+                out[k] = composeTransform(parent, positions[k], rotations[k], scales[k]);
+            continue;
+        }
+
+        const float* position = &positions[i].x;
+        const float* scale = &scales[i].x;
+        __m256 px = _mm256_i32gather_ps(position, vec3Stride, 4);
+        __m256 py = _mm256_i32gather_ps(position + 1, vec3Stride, 4);
+        __m256 pz = _mm256_i32gather_ps(position + 2, vec3Stride, 4);
+        __m256 sx = _mm256_i32gather_ps(scale, vec3Stride, 4);
+        __m256 sy = _mm256_i32gather_ps(scale + 1, vec3Stride, 4);
+        __m256 sz = _mm256_i32gather_ps(scale + 2, vec3Stride, 4);
+
+        // columns 0 and 1 in low, 2 and 3 in high, one row per matrix element
+        __m256 low[8], high[8];
+        for (int r = 0; r < 4; r++) {
+            low[r] = _mm256_mul_ps(p[r], sx);
+            low[4 + r] = _mm256_mul_ps(p[4 + r], sy);
+            high[r] = _mm256_mul_ps(p[8 + r], sz);
+            // same order of operations as composeTransform, so both paths give the same bits
+            __m256 translation = _mm256_add_ps(_mm256_mul_ps(p[r], px), _mm256_mul_ps(p[4 + r], py));
+            translation = _mm256_add_ps(translation, _mm256_mul_ps(p[8 + r], pz));
+            high[4 + r] = _mm256_add_ps(translation, p[12 + r]);
+        }
+
+        transpose8x8(low);
+        transpose8x8(high);
+        for (int k = 0; k < 8; k++) {
+            _mm256_storeu_ps(&out[i + k][0][0], low[k]);
+            _mm256_storeu_ps(&out[i + k][2][0], high[k]);
+        }
+    }
+#elif defined(BATCH_TRANSFORM_SSE)
+    __m128 column0 = _mm_loadu_ps(&parent[0][0]);
+    __m128 column1 = _mm_loadu_ps(&parent[1][0]);
+    __m128 column2 = _mm_loadu_ps(&parent[2][0]);
+    __m128 column3 = _mm_loadu_ps(&parent[3][0]);
+
+    for (; i < count; i++) {
+        if (rotations && rotations[i] != noRotation) {
+            out[i] = composeTransform(parent, positions[i], rotations[i], scales[i]);
+            continue;
+        }
+
+        const glm::vec3& position = positions[i];
+        const glm::vec3& scale = scales[i];
+        float* model = &out[i][0][0];
+        _mm_storeu_ps(model, _mm_mul_ps(column0, _mm_set1_ps(scale.x)));
+        _mm_storeu_ps(model + 4, _mm_mul_ps(column1, _mm_set1_ps(scale.y)));
+        _mm_storeu_ps(model + 8, _mm_mul_ps(column2, _mm_set1_ps(scale.z)));
+        __m128 translation = _mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(position.x)), _mm_mul_ps(column1, _mm_set1_ps(position.y)));
+        translation = _mm_add_ps(translation, _mm_mul_ps(column2, _mm_set1_ps(position.z)));
+        _mm_storeu_ps(model + 12, _mm_add_ps(translation, column3));
+    }
+#endif
+
+    for (; i < count; i++)
+        out[i] = composeTransform(parent, positions[i], rotations ? rotations[i] : noRotation, scales[i]);
+}
+
+#endif /* batchtransform_h */
@@ -0,0 +1,256 @@
+#pragma once
+//
+//  clusteredlights.h
+//  Clustered forward lighting for large numbers of point lights
+//
+//  The view frustum is split into froxels (screen tiles x exponential depth
+//  slices). Every frame each point light is binned into the froxels its
+//  attenuation range reaches, as jobs over the depth slices, and the result is
+//  uploaded into three texture buffers:
+//      clusterGrid     RG32UI   offset and count into lightIndexList per froxel
+//      lightIndexList  R32UI    light indices, grouped by froxel
+//      lightData       RGBA32F  4 texels per light (position/k_c, ambient/k_l, diffuse/k_q, specular)
+//  The lighting shader (CLUSTERED_LIGHTS variant) looks up the froxel of a
+//  vertex and only evaluates the lights listed there.
+//
+
+#ifndef clusteredlights_h
+#define clusteredlights_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+#include "shader.h"
+#include "pointlight.h"
+#include "jobsystem.h"
+
+// texture units used by the clustered lighting samplers
+const int CLUSTER_GRID_UNIT = 1;
+const int CLUSTER_INDEX_UNIT = 2;
+const int CLUSTER_LIGHT_UNIT = 3;
+
+class ClusteredLights {
+public:
+    static const int TILES_X = 16;
+    static const int TILES_Y = 9;
+    static const int SLICES = 24;
+    static const int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+    // a light stops being binned where its attenuation falls below this
+    float attenuationCutoff = 0.01f;
+
+    // number of light/froxel pairs after the last update, for statistics
+    unsigned int indexCount = 0;
+
+    void create()
+    {
+        createBuffer(gridBuffer, gridTexture, GL_RG32UI);
+        createBuffer(indexBuffer, indexTexture, GL_R32UI);
+        createBuffer(lightBuffer, lightTexture, GL_RGBA32F);
+    }
+
+    // distance at which 1 / (k_c + k_l d + k_q d^2) drops below the cutoff
+    float lightRange(const PointLight& light) const
+    {
+        float limit = 1.0f / attenuationCutoff;
+        if (light.k_c >= limit)
+            return 0.0f;    // already below the cutoff at the light itself
+        if (light.k_q > 0.0f) {
+            float c = light.k_c - limit;
+            float discriminant = std::max(0.0f, light.k_l * light.k_l - 4.0f * light.k_q * c);
+            return std::max(0.0f, (-light.k_l + std::sqrt(discriminant)) / (2.0f * light.k_q));
+        }
+        if (light.k_l > 0.0f)
+            return (limit - light.k_c) / light.k_l;
+        return 1e30f;   // no falloff, the light reaches everything
+    }
+
+    // bins every light into the froxels of the current view and uploads the lists
+    void update(const std::deque<PointLight>& lights, bool lightsChanged, const glm::mat4& view, float nearPlane, float farPlane, float tanHalfFOV, float aspect)
+    {
+        near_ = nearPlane;
+        far_ = farPlane;
+        sliceScale = SLICES / std::log(farPlane / nearPlane);
+
+        // view-space bounding spheres
+        spheres.resize(lights.size());
+        for (size_t i = 0; i < lights.size(); i++) {
+            glm::vec3 center = glm::vec3(view * glm::vec4(lights[i].position, 1.0f));
+            spheres[i] = glm::vec4(center, lightRange(lights[i]));
+        }
+
+        // depth slices are independent, so every job owns a range of slices
+        clusterLights.resize(CLUSTER_COUNT);
+        if (lights.size() < 64) {
+            binSlices(0, SLICES, tanHalfFOV, aspect);
+        }
+        else {
+            jobs.parallelFor(0, SLICES, 1, [&](size_t firstSlice, size_t endSlice) {
+                binSlices((int)firstSlice, (int)endSlice, tanHalfFOV, aspect);
+            });
+        }
+
+        // flatten into offset/count pairs and one index list
+        grid.resize(CLUSTER_COUNT * 2);
+        indices.clear();
+        for (int c = 0; c < CLUSTER_COUNT; c++) {
+            grid[c * 2] = (unsigned int)indices.size();
+            grid[c * 2 + 1] = (unsigned int)clusterLights[c].size();
+            indices.insert(indices.end(), clusterLights[c].begin(), clusterLights[c].end());
+        }
+        indexCount = (unsigned int)indices.size();
+        if (indices.empty())
+            indices.push_back(0);   // keep the buffer non-empty
+
+        upload(gridBuffer, grid.data(), grid.size() * sizeof(unsigned int));
+        upload(indexBuffer, indices.data(), indices.size() * sizeof(unsigned int));
+
+        if (lightsChanged || lightTexels.size() != lights.size() * 4) {
+            lightTexels.resize(lights.size() * 4);
+            for (size_t i = 0; i < lights.size(); i++) {
+                const PointLight& light = lights[i];
+                lightTexels[i * 4 + 0] = glm::vec4(light.position, light.k_c);
+                lightTexels[i * 4 + 1] = glm::vec4(light.ambientOn * light.ambient, light.k_l);
+                lightTexels[i * 4 + 2] = glm::vec4(light.diffuseOn * light.diffuse, light.k_q);
+                lightTexels[i * 4 + 3] = glm::vec4(light.specularOn * light.specular, 0.0f);
+            }
+            if (lightTexels.empty())
+                lightTexels.push_back(glm::vec4(0.0f));
+            upload(lightBuffer, lightTexels.data(), lightTexels.size() * sizeof(glm::vec4));
+        }
+    }
+
+    // binds the texture buffers and froxel parameters to a CLUSTERED_LIGHTS program
+    void bind(Shader& lightingShader)
+    {
+        bindTexture(CLUSTER_GRID_UNIT, gridTexture);
+        bindTexture(CLUSTER_INDEX_UNIT, indexTexture);
+        bindTexture(CLUSTER_LIGHT_UNIT, lightTexture);
+        glActiveTexture(GL_TEXTURE0);
+
+        lightingShader.use();
+        lightingShader.setInt("clusterGrid", CLUSTER_GRID_UNIT);
+        lightingShader.setInt("lightIndexList", CLUSTER_INDEX_UNIT);
+        lightingShader.setInt("lightData", CLUSTER_LIGHT_UNIT);
+        lightingShader.setVec4("clusterParams", (float)TILES_X, (float)TILES_Y, (float)SLICES, sliceScale);
+        lightingShader.setFloat("clusterNear", near_);
+    }
+
+    void release()
+    {
+        glDeleteTextures(1, &gridTexture);
+        glDeleteTextures(1, &indexTexture);
+        glDeleteTextures(1, &lightTexture);
+        glDeleteBuffers(1, &gridBuffer);
+        glDeleteBuffers(1, &indexBuffer);
+        glDeleteBuffers(1, &lightBuffer);
+    }
+
+private:
+    unsigned int gridBuffer = 0, gridTexture = 0;
+    unsigned int indexBuffer = 0, indexTexture = 0;
+    unsigned int lightBuffer = 0, lightTexture = 0;
+
+    float near_ = 0.1f;
+    float far_ = 100.0f;
+    float sliceScale = 1.0f;
+
+    std::vector<glm::vec4> spheres;
+    std::vector<std::vector<unsigned int>> clusterLights;
+    std::vector<unsigned int> grid;
+    std::vector<unsigned int> indices;
+    std::vector<glm::vec4> lightTexels;
+
+    // slice whose near boundary is at or in front of the view-space depth
+    int sliceOf(float depth) const
+    {
+        if (depth <= near_)
+            return 0;
+        int slice = (int)std::floor(std::log(depth / near_) * sliceScale);
+        return slice < SLICES ? slice : SLICES - 1;
+    }
+
+    // screen tile of an NDC coordinate, clamped to the grid
+    static int tileOf(float ndc, int tiles)
+    {
+        int tile = (int)std::floor((ndc * 0.5f + 0.5f) * tiles);
+        if (tile < 0) return 0;
+        if (tile >= tiles) return tiles - 1;
+        return tile;
+    }
+
+    void binSlices(int firstSlice, int endSlice, float tanHalfFOV, float aspect)
+    {
+        for (int c = firstSlice * TILES_X * TILES_Y; c < endSlice * TILES_X * TILES_Y; c++)
+            clusterLights[c].clear();
+
+        for (size_t i = 0; i < spheres.size(); i++) {
+            glm::vec3 center = glm::vec3(spheres[i]);
+            float radius = spheres[i].w;
+
+            // depth range, view space looks down -z
+            float minDepth = -center.z - radius;
+            float maxDepth = -center.z + radius;
+            if (maxDepth < near_ || minDepth > far_)
+                continue;
+            int z0 = sliceOf(minDepth);
+            int z1 = sliceOf(maxDepth);
+            if (z1 < firstSlice || z0 >= endSlice)
+                continue;
+            if (z0 < firstSlice) z0 = firstSlice;
+            if (z1 >= endSlice) z1 = endSlice - 1;
+
+            // conservative screen bounds of the sphere's box, taken at both depth extremes
+            float nearDepth = minDepth > near_ ? minDepth : near_;
+            float farDepth = maxDepth;
+            float x0 = 1.0f, x1 = -1.0f, y0 = 1.0f, y1 = -1.0f;
+            const float depths[2] = { nearDepth, farDepth };
+            for (float depth : depths) {
+                float sx = 1.0f / (depth * tanHalfFOV * aspect);
+                float sy = 1.0f / (depth * tanHalfFOV);
+                x0 = glm::min(x0, glm::min((center.x - radius) * sx, (center.x + radius) * sx));
+                x1 = glm::max(x1, glm::max((center.x - radius) * sx, (center.x + radius) * sx));
+                y0 = glm::min(y0, glm::min((center.y - radius) * sy, (center.y + radius) * sy));
+                y1 = glm::max(y1, glm::max((center.y - radius) * sy, (center.y + radius) * sy));
+            }
+            if (x1 < -1.0f || x0 > 1.0f || y1 < -1.0f || y0 > 1.0f)
+                continue;
+            int tx0 = tileOf(x0, TILES_X), tx1 = tileOf(x1, TILES_X);
+            int ty0 = tileOf(y0, TILES_Y), ty1 = tileOf(y1, TILES_Y);
+
+            for (int z = z0; z <= z1; z++)
+                for (int y = ty0; y <= ty1; y++)
+                    for (int x = tx0; x <= tx1; x++)
+                        clusterLights[(z * TILES_Y + y) * TILES_X + x].push_back((unsigned int)i);
+        }
+    }
+
+    static void createBuffer(unsigned int& buffer, unsigned int& texture, GLenum format)
+    {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_DYNAMIC_DRAW);
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    }
+
+    static void upload(unsigned int buffer, const void* data, size_t size)
+    {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    }
+
+    static void bindTexture(int unit, unsigned int texture)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+    }
+};
+
+#endif /* clusteredlights_h */
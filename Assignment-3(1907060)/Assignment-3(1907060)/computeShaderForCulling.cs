@@ -0,0 +1,49 @@
+#version 430 core
+// frustum culling of the static cubes, one invocation per cube
+// writes instanceCount of the cube's DrawElementsIndirectCommand, the other fields are filled once on the CPU
+
+layout (local_size_x = 64) in;
+
+struct Box {
+    vec4 center;
+    vec4 extent;
+};
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Boxes {
+    Box boxes[];
+};
+
+layout (std430, binding = 1) buffer Commands {
+    DrawCommand commands[];
+};
+
+uniform vec4 planes[6];
+uniform int objectCount;
+uniform bool culling;      // off: every cube is drawn, as keys 8/9 switch it for the CPU paths
+
+void main()
+{
+    int i = int(gl_GlobalInvocationID.x);
+    if (i >= objectCount)
+        return;
+
+    vec3 center = boxes[i].center.xyz;
+    vec3 extent = boxes[i].extent.xyz;
+
+    // outside when the whole box is behind one plane
+    bool inside = true;
+    for (int p = 0; p < 6 && culling; p++) {
+        if (dot(planes[p].xyz, center) + planes[p].w + dot(abs(planes[p].xyz), extent) < 0.0)
+            inside = false;
+    }
+
+    commands[i].instanceCount = inside ? 1u : 0u;
+}
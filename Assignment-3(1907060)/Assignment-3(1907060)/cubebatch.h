@@ -0,0 +1,162 @@
+#pragma once
+//
+//  cubebatch.h
+//  Instanced drawing of the unit cube
+//
+//  Collects the model matrix and color of every drawCube() call made while
+//  recording, and draws all of them with a single glDrawElementsInstanced
+//  against the cube VAO/EBO. After frustum culling only the visible
+//  instances are packed (in parallel, on the job system) into the instance
+//  buffer and drawn.
+//
+
+#ifndef cubebatch_h
+#define cubebatch_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "shader.h"
+#include "normalmatrix.h"
+#include "jobsystem.h"
+
+// per-instance data, read by vertexShaderForGouraudShading.vs at locations 2-9
+struct CubeInstance {
+    glm::mat4 model;
+    glm::vec3 color;
+    glm::mat3 normalMatrix;
+};
+
+class CubeBatch {
+public:
+    std::vector<CubeInstance> instances;
+    unsigned int instanceVBO = 0;
+    bool recording = false;
+
+    // everything drawn with drawCube() between begin() and end() goes to the batch
+    void begin()
+    {
+        instances.clear();
+        recording = true;
+    }
+
+    void add(const glm::mat4& model, const glm::vec3& color)
+    {
+        instances.push_back({ model, color, computeNormalMatrix(model) });
+    }
+
+    void end()
+    {
+        recording = false;
+        upload();
+    }
+
+    // adds the per-instance attributes to the cube VAO, the cube's own VBO/EBO stay as they are
+    void attach(unsigned int VAO)
+    {
+        if (instanceVBO == 0)
+            glGenBuffers(1, &instanceVBO);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+        // model matrix, one vec4 column per attribute location
+        for (unsigned int i = 0; i < 4; i++) {
+            glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, sizeof(CubeInstance), (void*)(i * sizeof(glm::vec4)));
+            glEnableVertexAttribArray(2 + i);
+            glVertexAttribDivisor(2 + i, 1);
+        }
+
+        // material color
+        glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(CubeInstance), (void*)offsetof(CubeInstance, color));
+        glEnableVertexAttribArray(6);
+        glVertexAttribDivisor(6, 1);
+
+        // normal matrix, one vec3 column per attribute location
+        for (unsigned int i = 0; i < 3; i++) {
+            glVertexAttribPointer(7 + i, 3, GL_FLOAT, GL_FALSE, sizeof(CubeInstance), (void*)(offsetof(CubeInstance, normalMatrix) + i * sizeof(glm::vec3)));
+            glEnableVertexAttribArray(7 + i);
+            glVertexAttribDivisor(7 + i, 1);
+        }
+
+        glBindVertexArray(0);
+    }
+
+    void upload()
+    {
+        if (instanceVBO == 0)
+            return;
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(CubeInstance), instances.data(), GL_DYNAMIC_DRAW);
+        packed = false;
+    }
+
+    void draw(Shader& lightingShader, unsigned int VAO)
+    {
+        if (packed)
+            upload();
+        drawInstances(lightingShader, VAO, instances.size());
+    }
+
+    // puts every instance back into the buffer after a culled draw packed a subset
+    void unpack()
+    {
+        if (packed)
+            upload();
+    }
+
+    // draws only the listed instances, e.g. FrustumCuller::visible
+    void draw(Shader& lightingShader, unsigned int VAO, const std::vector<unsigned int>& visible)
+    {
+        if (visible.size() == instances.size()) {
+            draw(lightingShader, VAO);
+            return;
+        }
+        if (visible.empty())
+            return;
+
+        visibleInstances.resize(visible.size());
+        jobs.parallelFor(0, visible.size(), 4096, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                visibleInstances[i] = instances[visible[i]];
+        });
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, visibleInstances.size() * sizeof(CubeInstance), visibleInstances.data());
+        packed = true;
+
+        drawInstances(lightingShader, VAO, visibleInstances.size());
+    }
+
+    void release()
+    {
+        glDeleteBuffers(1, &instanceVBO);
+        instanceVBO = 0;
+    }
+
+private:
+    std::vector<CubeInstance> visibleInstances;
+
+    // the buffer holds a culled subset instead of every instance
+    bool packed = false;
+
+    void drawInstances(Shader& lightingShader, unsigned int VAO, size_t count)
+    {
+        if (count == 0)
+            return;
+
+        lightingShader.use();
+        lightingShader.setBool("instanced", true);
+        lightingShader.setFloat("material.shininess", 32.0f);
+
+        glBindVertexArray(VAO);
+        glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0, (GLsizei)count);
+
+        lightingShader.setBool("instanced", false);
+    }
+};
+
+#endif /* cubebatch_h */
@@ -0,0 +1,76 @@
+#pragma once
+#ifndef directionalLight_h
+#define directionalLight_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "uniformbuffers.h"
+
+class DirectionalLight {
+public:
+    glm::vec3 direction;
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+
+    DirectionalLight(float dirX, float dirY, float dirZ, float ambR, float ambG, float ambB, float diffR, float diffG, float diffB, float specR, float specG, float specB) {
+        direction = glm::vec3(dirX, dirY, dirZ);
+        ambient = glm::vec3(ambR, ambG, ambB);
+        diffuse = glm::vec3(diffR, diffG, diffB);
+        specular = glm::vec3(specR, specG, specB);
+    }
+
+    // writes this light and its switches into the Lights uniform block
+    void setUpDirectionalLight(LightsBlock& lights)
+    {
+        DirectionalLightData& light = lights.directionalLight;
+        light.direction = direction;
+        light.ambient = ambient;
+        light.diffuse = diffuse;
+        light.specular = specular;
+        lights.directionLightOn = on;
+        lights.ambientLight = ambientOn;
+        lights.diffuseLight = diffuseOn;
+        lights.specularLight = specularOn;
+        dirty = false;
+    }
+
+    // call after changing any of the public light parameters directly
+    void markDirty() {
+        dirty = true;
+    }
+
+    void toggle() {
+        setSwitch(on, !on);
+    }
+
+    void toggleAmbient() {
+        setSwitch(ambientOn, !ambientOn);
+    }
+
+    void toggleDiffuse() {
+        setSwitch(diffuseOn, !diffuseOn);
+    }
+
+    void toggleSpecular() {
+        setSwitch(specularOn, !specularOn);
+    }
+
+    bool on = true;
+    bool ambientOn = true;
+    bool diffuseOn = true;
+    bool specularOn = true;
+
+    // set whenever the light changes, cleared once it has been written to the uniform block
+    bool dirty = true;
+
+private:
+    void setSwitch(bool& flag, bool value) {
+        if (flag != value) {
+            flag = value;
+            dirty = true;
+        }
+    }
+};
+
+#endif /* directionalLight_h */
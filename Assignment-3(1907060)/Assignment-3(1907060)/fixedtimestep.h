@@ -0,0 +1,65 @@
+#pragma once
+//
+//  fixedtimestep.h
+//  Fixed-rate simulation clock with an accumulator
+//
+//  Frame time is added to an accumulator and the simulation advances in
+//  whole ticks of a fixed length, so animation runs at the same speed and
+//  gives the same states whatever the render rate. The time left over is
+//  returned as alpha, the fraction of a tick the renderer is past the last
+//  tick; render state is interpolated between the last two ticks with it.
+//
+
+#ifndef fixedtimestep_h
+#define fixedtimestep_h
+
+#include <cmath>
+
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double tickSeconds = 1.0 / 60.0, int maxTicksPerFrame = 8)
+        : tick(tickSeconds), maxTicks(maxTicksPerFrame)
+    {
+    }
+
+    // adds a frame's time, returns how many ticks to simulate now
+    int advance(double frameSeconds)
+    {
+        accumulator += frameSeconds;
+        int ticks = 0;
+        while (accumulator >= tick && ticks < maxTicks) {
+            accumulator -= tick;
+            ticks++;
+        }
+        // after a stall (breakpoint, window drag) the backlog is dropped instead of replayed
+        if (accumulator >= tick)
+            accumulator = std::fmod(accumulator, tick);
+        tickCount += ticks;
+        return ticks;
+    }
+
+    // 0 right at the last tick, close to 1 just before the next one
+    float alpha() const
+    {
+        return (float)(accumulator / tick);
+    }
+
+    double tickSeconds() const
+    {
+        return tick;
+    }
+
+    // ticks simulated since the start
+    unsigned long long ticks() const
+    {
+        return tickCount;
+    }
+
+private:
+    double tick;
+    int maxTicks;
+    double accumulator = 0.0;
+    unsigned long long tickCount = 0;
+};
+
+#endif /* fixedtimestep_h */
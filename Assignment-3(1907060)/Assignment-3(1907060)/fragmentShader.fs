@@ -1,9 +1,11 @@
-#version 330 core
-uniform vec4 color;
-
-out vec4 FragColor;
-
-void main()
-{
-    FragColor = color;
+#version 330 core
+uniform vec4 color;
+uniform bool dynamicObject = false;
+flat in vec4 objectColorOut;
+
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = dynamicObject ? objectColorOut : color;
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
-#version 330 core
-out vec4 FragColor;
-
-in vec4 LightingColor;
-
-void main()
-{
-   FragColor = LightingColor;
+#version 330 core
+out vec4 FragColor;
+
+in vec4 LightingColor;
+
+void main()
+{
+   FragColor = LightingColor;
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
-#version 330 core
-in vec4 color;
-
-out vec4 FragColor;
-
-void main()
-{
-    FragColor = vec4(1.0f, 0.2f, 0.3f, 1.0f);
+#version 330 core
+in vec4 color;
+
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(1.0f, 0.2f, 0.3f, 1.0f);
 }
\ No newline at end of file
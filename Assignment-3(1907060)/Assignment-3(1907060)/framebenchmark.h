@@ -0,0 +1,236 @@
+#pragma once
+//
+//  framebenchmark.h
+//  Offscreen render target and a fixed-length frame-time benchmark
+//
+//  OffscreenTarget is a framebuffer object with color and depth
+//  renderbuffers, so frames can be rendered and timed without anything
+//  being shown. FrameBenchmark drives a run of N frames: it gives the
+//  camera pose of every frame along a scripted orbit, times each frame on
+//  the CPU and, with one GL_TIME_ELAPSED query per frame, on the GPU. The
+//  queries are only read after the last frame, so timing never stalls the
+//  pipeline. The results are written per frame with p50/p95/p99 and the
+//  mean, as JSON or CSV depending on the file extension.
+//
+
+#ifndef framebenchmark_h
+#define framebenchmark_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class OffscreenTarget {
+public:
+    unsigned int FBO = 0;
+    int width = 0;
+    int height = 0;
+
+    bool create(int targetWidth, int targetHeight)
+    {
+        release();
+        width = targetWidth;
+        height = targetHeight;
+
+        glGenRenderbuffers(1, &colorRBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glGenRenderbuffers(1, &depthRBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &FBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!complete) {
+            std::cout << "ERROR::FRAMEBUFFER::INCOMPLETE: offscreen target " << width << "x" << height << std::endl;
+            release();
+        }
+        return complete;
+    }
+
+    // renders into the target from now on, over its whole area
+    void bind() const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glViewport(0, 0, width, height);
+    }
+
+    void release()
+    {
+        if (FBO)
+            glDeleteFramebuffers(1, &FBO);
+        if (colorRBO)
+            glDeleteRenderbuffers(1, &colorRBO);
+        if (depthRBO)
+            glDeleteRenderbuffers(1, &depthRBO);
+        FBO = colorRBO = depthRBO = 0;
+    }
+
+private:
+    unsigned int colorRBO = 0;
+    unsigned int depthRBO = 0;
+};
+
+struct CameraPose {
+    glm::vec3 position;
+    glm::vec3 target;
+};
+
+class FrameBenchmark {
+public:
+    // the scripted path: one orbit around center, bobbing up and down twice
+    glm::vec3 center = glm::vec3(3.0f, 1.8f, 4.0f);
+    float radius = 3.5f;
+    float height = 3.0f;
+    float bob = 0.6f;
+
+    void start(int frames, const std::string& outputPath)
+    {
+        release();
+        frameCount = std::max(1, frames);
+        frame = 0;
+        path = outputPath;
+        cpuMs.assign(frameCount, 0.0);
+        gpuMs.assign(frameCount, 0.0);
+        queries.resize(frameCount);
+        glGenQueries(frameCount, queries.data());
+    }
+
+    bool active() const
+    {
+        return frameCount > 0;
+    }
+
+    bool finished() const
+    {
+        return frame >= frameCount;
+    }
+
+    // camera of the current frame, the same for every run of the same length
+    CameraPose pose() const
+    {
+        const float TWO_PI = 6.28318530718f;
+        float t = (float)frame / (float)frameCount;
+        float angle = t * TWO_PI;
+        CameraPose result;
+        result.position = center + glm::vec3(radius * std::cos(angle), height - center.y + bob * std::sin(2.0f * angle), radius * std::sin(angle));
+        result.target = center;
+        return result;
+    }
+
+    // call before the first GL command of the frame
+    void beginFrame()
+    {
+        cpuStart = std::chrono::high_resolution_clock::now();
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame]);
+    }
+
+    // call after the last GL command of the frame, before the swap
+    void endFrame()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        cpuMs[frame] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - cpuStart).count();
+        frame++;
+    }
+
+    // reads the GPU times, prints the summary and writes the file; false when the file cannot be written
+    bool writeResults()
+    {
+        for (int i = 0; i < frameCount; i++) {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &nanoseconds);
+            gpuMs[i] = nanoseconds / 1.0e6;
+        }
+
+        Summary cpu = summarize(cpuMs), gpu = summarize(gpuMs);
+        std::cout << "benchmark " << frameCount << " frames | cpu ms p50 " << cpu.p50 << " p95 " << cpu.p95 << " p99 " << cpu.p99
+                  << " | gpu ms p50 " << gpu.p50 << " p95 " << gpu.p95 << " p99 " << gpu.p99 << std::endl;
+
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            std::cout << "ERROR::BENCHMARK::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+            return false;
+        }
+        bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        if (csv)
+            writeCsv(out, cpu, gpu);
+        else
+            writeJson(out, cpu, gpu);
+        return (bool)out;
+    }
+
+    void release()
+    {
+        if (!queries.empty())
+            glDeleteQueries((GLsizei)queries.size(), queries.data());
+        queries.clear();
+        frameCount = 0;
+    }
+
+private:
+    struct Summary {
+        double p50, p95, p99, mean;
+    };
+
+    int frameCount = 0;
+    int frame = 0;
+    std::string path;
+    std::vector<unsigned int> queries;
+    std::vector<double> cpuMs;
+    std::vector<double> gpuMs;
+    std::chrono::high_resolution_clock::time_point cpuStart;
+
+    // nearest-rank percentiles
+    static Summary summarize(std::vector<double> ms)
+    {
+        std::sort(ms.begin(), ms.end());
+        auto percentile = [&](double p) {
+            size_t rank = (size_t)std::ceil(p / 100.0 * ms.size());
+            return ms[std::min(ms.size() - 1, rank > 0 ? rank - 1 : 0)];
+        };
+        double sum = 0.0;
+        for (double value : ms)
+            sum += value;
+        return { percentile(50.0), percentile(95.0), percentile(99.0), sum / ms.size() };
+    }
+
+    void writeJson(std::ofstream& out, const Summary& cpu, const Summary& gpu) const
+    {
+        auto summary = [&](const char* name, const Summary& s) {
+            out << "  \"" << name << "\": { \"p50\": " << s.p50 << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"mean\": " << s.mean << " },\n";
+        };
+        out << "{\n  \"frames\": " << frameCount << ",\n";
+        summary("cpu_ms", cpu);
+        summary("gpu_ms", gpu);
+        out << "  \"per_frame\": [\n";
+        for (int i = 0; i < frameCount; i++)
+            out << "    { \"cpu_ms\": " << cpuMs[i] << ", \"gpu_ms\": " << gpuMs[i] << " }" << (i + 1 < frameCount ? ",\n" : "\n");
+        out << "  ]\n}\n";
+    }
+
+    // one row per frame, then the summary rows named in the frame column
+    void writeCsv(std::ofstream& out, const Summary& cpu, const Summary& gpu) const
+    {
+        out << "frame,cpu_ms,gpu_ms\n";
+        for (int i = 0; i < frameCount; i++)
+            out << i << "," << cpuMs[i] << "," << gpuMs[i] << "\n";
+        out << "p50," << cpu.p50 << "," << gpu.p50 << "\n";
+        out << "p95," << cpu.p95 << "," << gpu.p95 << "\n";
+        out << "p99," << cpu.p99 << "," << gpu.p99 << "\n";
+        out << "mean," << cpu.mean << "," << gpu.mean << "\n";
+    }
+};
+
+#endif /* framebenchmark_h */
@@ -0,0 +1,165 @@
+#pragma once
+//
+//  frametrace.h
+//  Timeline of begin/end events, exported as Chrome Trace Event JSON
+//
+//  Every thread that records gets its own fixed-size ring of events the
+//  first time it records; only that thread writes to it, so recording is
+//  a clock read and a store, no lock and no allocation. When a ring is
+//  full the oldest events are overwritten, so the trace always holds the
+//  last few seconds before an export. write() turns all rings into a
+//  JSON file that chrome://tracing and Perfetto open directly. It reads
+//  the rings while others may still write, so call it between frames,
+//  when no jobs are running.
+//
+//  Event names are not copied, they must be string literals.
+//
+
+#ifndef frametrace_h
+#define frametrace_h
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class FrameTrace {
+public:
+    static const size_t EVENTS_PER_THREAD = 1 << 16;
+
+    std::atomic<bool> recording{ false };
+
+    // nanoseconds since the trace clock started
+    uint64_t now() const
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    // label of the calling thread in the trace, a string literal; call before it records
+    static void setThreadName(const char* name)
+    {
+        threadName() = name;
+    }
+
+    // one complete event on the calling thread's ring
+    void record(const char* name, uint64_t beginNs, uint64_t endNs)
+    {
+        ThreadEvents& events = threadEvents();
+        uint64_t index = events.written.load(std::memory_order_relaxed);
+        events.ring[index % EVENTS_PER_THREAD] = { name, beginNs, endNs };
+        events.written.store(index + 1, std::memory_order_release);
+    }
+
+    // false when the file cannot be written
+    bool write(const std::string& path)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            std::cout << "ERROR::TRACE::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(threadsLock);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        size_t total = 0;
+        for (size_t t = 0; t < threads.size(); t++) {
+            ThreadEvents& events = *threads[t];
+            out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":\"" << events.name << " " << t << "\"}}";
+            first = false;
+
+            uint64_t written = events.written.load(std::memory_order_acquire);
+            uint64_t oldest = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0;
+            for (uint64_t i = oldest; i < written; i++) {
+                const Event& event = events.ring[i % EVENTS_PER_THREAD];
+                // microseconds, with the nanoseconds kept as fraction
+                out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t
+                    << ",\"ts\":" << event.beginNs / 1000 << "." << pad3(event.beginNs % 1000)
+                    << ",\"dur\":" << (event.endNs - event.beginNs) / 1000 << "." << pad3((event.endNs - event.beginNs) % 1000) << "}";
+            }
+            total += (size_t)(written - oldest);
+        }
+        out << "\n]}\n";
+        std::cout << "trace of " << total << " events written to " << path << std::endl;
+        return (bool)out;
+    }
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t beginNs;
+        uint64_t endNs;
+    };
+
+    struct ThreadEvents {
+        const char* name;
+        std::unique_ptr<Event[]> ring{ new Event[EVENTS_PER_THREAD] };
+        std::atomic<uint64_t> written{ 0 };
+    };
+
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::mutex threadsLock;     // only taken when a thread records for the first time and by write()
+    std::vector<std::unique_ptr<ThreadEvents>> threads;
+
+    ThreadEvents& threadEvents()
+    {
+        static thread_local ThreadEvents* events = nullptr;
+        if (!events) {
+            std::lock_guard<std::mutex> lock(threadsLock);
+            threads.emplace_back(new ThreadEvents());
+            events = threads.back().get();
+            events->name = threadName();
+        }
+        return *events;
+    }
+
+    static const char*& threadName()
+    {
+        static thread_local const char* name = "thread";
+        return name;
+    }
+
+    static std::string pad3(uint64_t value)
+    {
+        std::string digits = std::to_string(value);
+        return std::string(3 - std::min<size_t>(3, digits.size()), '0') + digits;
+    }
+};
+
+// the one trace of the program, recording is switched on in main() with --trace
+inline FrameTrace frameTrace;
+
+// records its own lifetime under name while the trace is recording
+class TraceScope {
+public:
+    explicit TraceScope(const char* eventName)
+        : name(eventName)
+    {
+        if (frameTrace.recording.load(std::memory_order_relaxed))
+            begin = frameTrace.now();
+    }
+
+    ~TraceScope()
+    {
+        if (begin != NOT_RECORDING)
+            frameTrace.record(name, begin, frameTrace.now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    static const uint64_t NOT_RECORDING = ~0ull;
+
+    const char* name;
+    uint64_t begin = NOT_RECORDING;
+};
+
+#endif /* frametrace_h */
@@ -0,0 +1,155 @@
+#pragma once
+//
+//  glextensions.h
+//  OpenGL entry points newer than the 3.3 core profile the project targets
+//
+//  glad is generated for 3.3, so the few 4.x functions the optional render
+//  paths need are looked up here after the context exists. A pointer stays
+//  null when the driver does not export it, and every feature checks its
+//  functions before it enables itself; 3.3 contexts keep working unchanged.
+//
+
+#ifndef glextensions_h
+#define glextensions_h
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+// enums from GL 4.1 (program binaries)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+// enums from KHR_parallel_shader_compile (ARB_parallel_shader_compile uses the same value)
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// enums from GL 4.3 (compute shaders, shader storage, indirect draws)
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+
+// enums from GL 4.4 (buffer storage)
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+typedef void (APIENTRYP GLExtGetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP GLExtProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP GLExtProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP GLExtMaxShaderCompilerThreadsProc)(GLuint count);
+typedef void (APIENTRYP GLExtDispatchComputeProc)(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+typedef void (APIENTRYP GLExtMemoryBarrierProc)(GLbitfield barriers);
+typedef void (APIENTRYP GLExtMultiDrawElementsIndirectProc)(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride);
+typedef void (APIENTRYP GLExtBufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+typedef void* (*GLExtLoadProc)(const char* name);
+
+struct GLExtensions {
+    // version of the context that was actually created
+    GLint major = 0;
+    GLint minor = 0;
+    // binary formats the driver can save programs in, 0 when it has none
+    GLint programBinaryFormats = 0;
+    // the driver compiles and links on its own threads and reports progress with GL_COMPLETION_STATUS_KHR
+    bool parallelShaderCompile = false;
+
+    GLExtGetProgramBinaryProc getProgramBinary = nullptr;
+    GLExtProgramBinaryProc programBinary = nullptr;
+    GLExtProgramParameteriProc programParameteri = nullptr;
+    GLExtMaxShaderCompilerThreadsProc maxShaderCompilerThreads = nullptr;
+    GLExtDispatchComputeProc dispatchCompute = nullptr;
+    GLExtMemoryBarrierProc memoryBarrier = nullptr;
+    GLExtMultiDrawElementsIndirectProc multiDrawElementsIndirect = nullptr;
+    GLExtBufferStorageProc bufferStorage = nullptr;
+
+    bool atLeast(int wantedMajor, int wantedMinor) const
+    {
+        return major > wantedMajor || (major == wantedMajor && minor >= wantedMinor);
+    }
+
+    // linked programs saved and restored as driver binaries (GL 4.1 or ARB_get_program_binary)
+    bool programBinarySupported() const
+    {
+        return getProgramBinary && programBinary && programParameteri && programBinaryFormats > 0;
+    }
+
+    // programs can be polled with GL_COMPLETION_STATUS_KHR instead of blocking on their status
+    bool parallelShaderCompileSupported() const
+    {
+        return parallelShaderCompile;
+    }
+
+    // compute culling writing the commands of one glMultiDrawElementsIndirect
+    bool gpuDrivenSupported() const
+    {
+        return atLeast(4, 3) && dispatchCompute && memoryBarrier && multiDrawElementsIndirect;
+    }
+
+    // immutable storage that can stay mapped while the GPU reads it
+    bool persistentMappingSupported() const
+    {
+        return atLeast(4, 4) && bufferStorage;
+    }
+};
+
+inline GLExtensions glext;
+
+// call once after gladLoadGLLoader, with the same loader
+inline void loadGLExtensions(GLExtLoadProc load)
+{
+    glGetIntegerv(GL_MAJOR_VERSION, &glext.major);
+    glGetIntegerv(GL_MINOR_VERSION, &glext.minor);
+
+    glext.getProgramBinary = (GLExtGetProgramBinaryProc)load("glGetProgramBinary");
+    glext.programBinary = (GLExtProgramBinaryProc)load("glProgramBinary");
+    glext.programParameteri = (GLExtProgramParameteriProc)load("glProgramParameteri");
+    if (glext.getProgramBinary && glext.programBinary)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &glext.programBinaryFormats);
+
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount; i++) {
+        const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 || std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0))
+            glext.parallelShaderCompile = true;
+    }
+    if (glext.parallelShaderCompile) {
+        glext.maxShaderCompilerThreads = (GLExtMaxShaderCompilerThreadsProc)load("glMaxShaderCompilerThreadsKHR");
+        if (!glext.maxShaderCompilerThreads)
+            glext.maxShaderCompilerThreads = (GLExtMaxShaderCompilerThreadsProc)load("glMaxShaderCompilerThreadsARB");
+        // as many compiler threads as the driver wants
+        if (glext.maxShaderCompilerThreads)
+            glext.maxShaderCompilerThreads(0xFFFFFFFFu);
+    }
+
+    glext.dispatchCompute = (GLExtDispatchComputeProc)load("glDispatchCompute");
+    glext.memoryBarrier = (GLExtMemoryBarrierProc)load("glMemoryBarrier");
+    glext.multiDrawElementsIndirect = (GLExtMultiDrawElementsIndirectProc)load("glMultiDrawElementsIndirect");
+    glext.bufferStorage = (GLExtBufferStorageProc)load("glBufferStorage");
+}
+
+#endif /* glextensions_h */
@@ -0,0 +1,137 @@
+#pragma once
+//
+//  gpuculler.h
+//  GPU-driven drawing of the static cubes
+//
+//  The world AABB of every static cube is uploaded once into a shader
+//  storage buffer, next to one DrawElementsIndirectCommand per cube whose
+//  baseInstance selects the cube's row of the CubeBatch instance buffer.
+//  Each frame computeShaderForCulling.cs sets instanceCount to 0 or 1 per
+//  cube and a single glMultiDrawElementsIndirect draws the survivors, so the
+//  CPU work per frame is the same whatever the number of cubes.
+//  Needs GL 4.3, see glextensions.h.
+//
+
+#ifndef gpuculler_h
+#define gpuculler_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "glextensions.h"
+#include "shader.h"
+#include "cubebatch.h"
+#include "frustumculler.h"
+
+// layout of one indirect command, as glMultiDrawElementsIndirect reads it
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+class GpuCuller {
+public:
+    // false when the context cannot run the compute pass, the mode then stays unavailable
+    bool create(const FrustumCuller& boxes, GLuint cubeIndexCount)
+    {
+        if (!glext.gpuDrivenSupported())
+            return false;
+
+        cullShader.reset(new Shader("computeShaderForCulling.cs"));
+        planeLocations.clear();
+        for (int p = 0; p < 6; p++)
+            planeLocations.push_back(cullShader->uniformLocation("planes[" + std::to_string(p) + "]"));
+        objectCountLocation = cullShader->uniformLocation("objectCount");
+        cullingLocation = cullShader->uniformLocation("culling");
+
+        objectCount = (GLsizei)boxes.size();
+
+        // std430 vec4 center, vec4 extent
+        std::vector<glm::vec4> boxData;
+        boxData.reserve(objectCount * 2);
+        for (size_t i = 0; i < boxes.size(); i++) {
+            boxData.push_back(glm::vec4(boxes.center(i), 1.0f));
+            boxData.push_back(glm::vec4(boxes.extent(i), 0.0f));
+        }
+
+        std::vector<DrawElementsIndirectCommand> commands(objectCount);
+        for (GLsizei i = 0; i < objectCount; i++)
+            commands[i] = { cubeIndexCount, 1, 0, 0, (GLuint)i };
+
+        glGenBuffers(1, &boxBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, boxBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, boxData.size() * sizeof(glm::vec4), boxData.data(), GL_STATIC_DRAW);
+
+        glGenBuffers(1, &commandBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return true;
+    }
+
+    bool available() const
+    {
+        return cullShader != nullptr;
+    }
+
+    // culls on the GPU (unless culling is off) and draws the visible instances of batch with the instanced path of the lighting shader
+    void draw(Shader& lightingShader, unsigned int VAO, CubeBatch& batch, const glm::mat4& viewProjection, bool culling)
+    {
+        if (!available() || objectCount == 0)
+            return;
+
+        // baseInstance addresses the full instance buffer, not a culled subset
+        batch.unpack();
+
+        Frustum frustum = extractFrustum(viewProjection);
+        cullShader->use();
+        for (int p = 0; p < 6; p++)
+            cullShader->setVec4(planeLocations[p], frustum.planes[p]);
+        cullShader->setInt(objectCountLocation, (int)objectCount);
+        cullShader->setBool(cullingLocation, culling);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, boxBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commandBuffer);
+        glext.dispatchCompute((GLuint)(objectCount + 63) / 64, 1, 1);
+        glext.memoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+        lightingShader.use();
+        lightingShader.setBool("instanced", true);
+        lightingShader.setFloat("material.shininess", 32.0f);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glext.multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0, objectCount, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        lightingShader.setBool("instanced", false);
+    }
+
+    void release()
+    {
+        if (cullShader)
+            glDeleteProgram(cullShader->ID);
+        cullShader.reset();
+        glDeleteBuffers(1, &boxBuffer);
+        glDeleteBuffers(1, &commandBuffer);
+        boxBuffer = commandBuffer = 0;
+    }
+
+private:
+    std::unique_ptr<Shader> cullShader;
+    std::vector<GLint> planeLocations;
+    GLint objectCountLocation = -1;
+    GLint cullingLocation = -1;
+    GLsizei objectCount = 0;
+    unsigned int boxBuffer = 0;
+    unsigned int commandBuffer = 0;
+};
+
+#endif /* gpuculler_h */
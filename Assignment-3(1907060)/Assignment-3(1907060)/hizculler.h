@@ -0,0 +1,373 @@
+#pragma once
+//
+//  hizculler.h
+//  Software hierarchical-Z occlusion culling, entirely on the CPU
+//
+//  The large boxes of the scene (floor, walls, refrigerator, shelves) are
+//  rasterized as occluders into a small depth buffer, 4 pixels at a time
+//  with SSE. The screen is split into tiles and every job rasterizes its
+//  own tiles, so no two threads write the same pixel. A pyramid of min and
+//  max depths is then built over the buffer. An object is hidden when the
+//  nearest point of its box is behind the farthest occluder depth of every
+//  pyramid texel its screen rectangle touches.
+//
+//  Nothing here touches OpenGL, so the culler can run and be timed without
+//  a context.
+//
+
+#ifndef hizculler_h
+#define hizculler_h
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "frustumculler.h"
+#include "jobsystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HIZ_SSE
+#endif
+
+class HiZCuller {
+public:
+    static const int WIDTH = 256;
+    static const int HEIGHT = 128;
+    static const int TILE_WIDTH = 32;       // 8x8 tiles, enough jobs for 16 threads and more
+    static const int TILE_HEIGHT = 16;
+    static const int TILES_X = WIDTH / TILE_WIDTH;
+    static const int TILES_Y = HEIGHT / TILE_HEIGHT;
+    static const int LEVELS = 8;            // 256x128 down to 2x1
+    static const int TILE_LEVELS = 5;       // levels a tile can build on its own, down to 2x1 per tile
+
+    // boxes with a face at least this large (m^2) are used as occluders
+    float occluderMinArea = 1.0f;
+
+    struct Stats {
+        unsigned int occluders = 0;
+        unsigned int triangles = 0;
+        unsigned int tested = 0;
+        unsigned int culled = 0;
+        double rasterMs = 0.0;      // rasterization and pyramid
+        double testMs = 0.0;
+    } stats;
+
+    HiZCuller()
+    {
+        for (int level = 0; level < LEVELS; level++) {
+            maxDepth[level].assign((size_t)levelWidth(level) * levelHeight(level), 1.0f);
+            minDepth[level].assign((size_t)levelWidth(level) * levelHeight(level), 1.0f);
+        }
+    }
+
+    static int levelWidth(int level) { return WIDTH >> level; }
+    static int levelHeight(int level) { return HEIGHT >> level; }
+
+    // farthest occluder depth (0 near, 1 far) of a pyramid texel
+    float farthestDepth(int level, int x, int y) const
+    {
+        return maxDepth[level][(size_t)y * levelWidth(level) + x];
+    }
+
+    // picks the occluders among boxes, call again when the boxes change
+    void selectOccluders(const FrustumCuller& boxes)
+    {
+        occluders.clear();
+        for (size_t i = 0; i < boxes.size(); i++) {
+            glm::vec3 size = 2.0f * boxes.extent(i);
+            float largestFace = std::max(size.x * size.y, std::max(size.y * size.z, size.x * size.z));
+            if (largestFace >= occluderMinArea)
+                occluders.push_back((unsigned int)i);
+        }
+    }
+
+    // rasterizes the occluders seen through viewProjection and builds the pyramid
+    void render(const FrustumCuller& boxes, const glm::mat4& viewProjection)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        setUpTriangles(boxes, viewProjection);
+
+        jobs.parallelFor(0, TILES_X * TILES_Y, 1, [this](size_t firstTile, size_t endTile) {
+            renderTiles((int)firstTile, (int)endTile);
+        });
+
+        // the last levels span several tiles
+        for (int level = TILE_LEVELS; level < LEVELS; level++)
+            buildLevel(level, 0, 0, levelWidth(level), levelHeight(level));
+
+        stats.rasterMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // keeps the candidates (ascending indices) that are not hidden behind the occluders
+    void test(const std::vector<unsigned int>& candidates, const FrustumCuller& boxes, const glm::mat4& viewProjection, std::vector<unsigned int>& visible)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // enough work per job to pay for scheduling it, results joined in order
+        partialResults.resize(jobs.chunksFor(candidates.size(), 256));
+        jobs.parallelForChunks(candidates.size(), partialResults.size(), [&](size_t chunk, size_t first, size_t end) {
+            testRange(candidates, boxes, viewProjection, first, end, partialResults[chunk]);
+        });
+
+        visible.clear();
+        if (!candidates.empty())
+            for (const std::vector<unsigned int>& partial : partialResults)
+                visible.insert(visible.end(), partial.begin(), partial.end());
+
+        stats.tested = (unsigned int)candidates.size();
+        stats.culled = stats.tested - (unsigned int)visible.size();
+        stats.testMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+private:
+    // screen-space triangle with its edge functions and depth plane, all as A*x + B*y + C
+    struct Triangle {
+        float edgeA[3], edgeB[3], edgeC[3];
+        float depthA, depthB, depthC;
+        int minX, maxX, minY, maxY;
+    };
+
+    std::vector<float> maxDepth[LEVELS];
+    std::vector<float> minDepth[LEVELS];
+    std::vector<unsigned int> occluders;
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<unsigned int>> partialResults;
+
+    // clip space to pixel coordinates (x, y) and depth in [0, 1]
+    static glm::vec3 toScreen(const glm::vec4& clip)
+    {
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        return glm::vec3((ndc.x * 0.5f + 0.5f) * WIDTH, (ndc.y * 0.5f + 0.5f) * HEIGHT, ndc.z * 0.5f + 0.5f);
+    }
+
+    static void boxCorners(const FrustumCuller& boxes, unsigned int index, const glm::mat4& viewProjection, glm::vec4 corners[8])
+    {
+        glm::vec3 center = boxes.center(index);
+        glm::vec3 extent = boxes.extent(index);
+        for (int c = 0; c < 8; c++) {
+            glm::vec3 corner = center + glm::vec3((c & 1) ? extent.x : -extent.x, (c & 2) ? extent.y : -extent.y, (c & 4) ? extent.z : -extent.z);
+            corners[c] = viewProjection * glm::vec4(corner, 1.0f);
+        }
+    }
+
+    void setUpTriangles(const FrustumCuller& boxes, const glm::mat4& viewProjection)
+    {
+        // the 12 triangles of a box, corners numbered by the bits x=1, y=2, z=4
+        static const int faces[12][3] = {
+            { 0, 2, 3 }, { 0, 3, 1 },   // -z
+            { 4, 5, 7 }, { 4, 7, 6 },   // +z
+            { 0, 4, 6 }, { 0, 6, 2 },   // -x
+            { 1, 3, 7 }, { 1, 7, 5 },   // +x
+            { 0, 1, 5 }, { 0, 5, 4 },   // -y
+            { 2, 6, 7 }, { 2, 7, 3 }    // +y
+        };
+
+        triangles.clear();
+        stats.occluders = 0;
+        for (unsigned int index : occluders) {
+            glm::vec4 corners[8];
+            boxCorners(boxes, index, viewProjection, corners);
+
+            // an occluder crossing the near plane is left out, which only makes the culling less aggressive
+            bool crossesNear = false;
+            for (const glm::vec4& corner : corners)
+                if (corner.w <= 1e-4f || corner.z < -corner.w)
+                    crossesNear = true;
+            if (crossesNear)
+                continue;
+
+            glm::vec3 screen[8];
+            for (int c = 0; c < 8; c++)
+                screen[c] = toScreen(corners[c]);
+
+            stats.occluders++;
+            for (const int* face : faces)
+                addTriangle(screen[face[0]], screen[face[1]], screen[face[2]]);
+        }
+        stats.triangles = (unsigned int)triangles.size();
+    }
+
+    void addTriangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2)
+    {
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+        if (area == 0.0f)
+            return;
+        if (area < 0.0f) {
+            // both windings are rasterized, the nearest depth wins anyway
+            std::swap(v1, v2);
+            area = -area;
+        }
+
+        Triangle triangle;
+        const glm::vec3* v[3] = { &v0, &v1, &v2 };
+        for (int e = 0; e < 3; e++) {
+            const glm::vec3& a = *v[e];
+            const glm::vec3& b = *v[(e + 1) % 3];
+            triangle.edgeA[e] = -(b.y - a.y);
+            triangle.edgeB[e] = b.x - a.x;
+            triangle.edgeC[e] = -triangle.edgeA[e] * a.x - triangle.edgeB[e] * a.y;
+        }
+
+        // barycentric weight of v1 is edge 2 (v2->v0), of v2 is edge 0 (v0->v1)
+        float dz1 = (v1.z - v0.z) / area, dz2 = (v2.z - v0.z) / area;
+        triangle.depthA = triangle.edgeA[2] * dz1 + triangle.edgeA[0] * dz2;
+        triangle.depthB = triangle.edgeB[2] * dz1 + triangle.edgeB[0] * dz2;
+        triangle.depthC = v0.z + triangle.edgeC[2] * dz1 + triangle.edgeC[0] * dz2;
+
+        triangle.minX = std::max(0, (int)std::floor(std::min(v0.x, std::min(v1.x, v2.x))));
+        triangle.maxX = std::min(WIDTH - 1, (int)std::ceil(std::max(v0.x, std::max(v1.x, v2.x))));
+        triangle.minY = std::max(0, (int)std::floor(std::min(v0.y, std::min(v1.y, v2.y))));
+        triangle.maxY = std::min(HEIGHT - 1, (int)std::ceil(std::max(v0.y, std::max(v1.y, v2.y))));
+        if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+            return;
+
+        triangles.push_back(triangle);
+    }
+
+    void renderTiles(int firstTile, int endTile)
+    {
+        for (int tile = firstTile; tile < endTile; tile++) {
+            int x0 = (tile % TILES_X) * TILE_WIDTH, y0 = (tile / TILES_X) * TILE_HEIGHT;
+            int x1 = x0 + TILE_WIDTH, y1 = y0 + TILE_HEIGHT;
+
+            std::vector<float>& depth = maxDepth[0];
+            for (int y = y0; y < y1; y++)
+                std::fill(depth.begin() + (size_t)y * WIDTH + x0, depth.begin() + (size_t)y * WIDTH + x1, 1.0f);
+
+            for (const Triangle& triangle : triangles) {
+                if (triangle.maxX < x0 || triangle.minX >= x1 || triangle.maxY < y0 || triangle.minY >= y1)
+                    continue;
+                rasterize(triangle, std::max(triangle.minX, x0) & ~3, std::min(triangle.maxX + 1, x1), std::max(triangle.minY, y0), std::min(triangle.maxY + 1, y1));
+            }
+
+            // level 0 has a single depth, min and max are the same buffer content
+            for (int y = y0; y < y1; y++)
+                std::copy(depth.begin() + (size_t)y * WIDTH + x0, depth.begin() + (size_t)y * WIDTH + x1, minDepth[0].begin() + (size_t)y * WIDTH + x0);
+            for (int level = 1; level < TILE_LEVELS; level++)
+                buildLevel(level, x0 >> level, y0 >> level, x1 >> level, y1 >> level);
+        }
+    }
+
+    // depth test against pixel centers of the rows [y0, y1) and columns [x0, x1), x0 a multiple of 4
+    void rasterize(const Triangle& t, int x0, int x1, int y0, int y1)
+    {
+        float* depth = maxDepth[0].data();
+
+#if defined(HIZ_SSE)
+        const __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        __m128 edgeA0 = _mm_set1_ps(t.edgeA[0]), edgeA1 = _mm_set1_ps(t.edgeA[1]), edgeA2 = _mm_set1_ps(t.edgeA[2]);
+        __m128 depthA = _mm_set1_ps(t.depthA);
+
+        for (int y = y0; y < y1; y++) {
+            float py = y + 0.5f;
+            __m128 rowE0 = _mm_set1_ps(t.edgeB[0] * py + t.edgeC[0]);
+            __m128 rowE1 = _mm_set1_ps(t.edgeB[1] * py + t.edgeC[1]);
+            __m128 rowE2 = _mm_set1_ps(t.edgeB[2] * py + t.edgeC[2]);
+            __m128 rowZ = _mm_set1_ps(t.depthB * py + t.depthC);
+            float* row = depth + (size_t)y * WIDTH;
+
+            for (int x = x0; x < x1; x += 4) {
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(edgeA0, px), rowE0);
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(edgeA1, px), rowE1);
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(edgeA2, px), rowE2);
+                __m128 inside = _mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_and_ps(_mm_cmpge_ps(e1, zero), _mm_cmpge_ps(e2, zero)));
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+
+                __m128 z = _mm_add_ps(_mm_mul_ps(depthA, px), rowZ);
+                __m128 current = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(current, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+            }
+        }
+#else
+        for (int y = y0; y < y1; y++) {
+            float py = y + 0.5f;
+            float* row = depth + (size_t)y * WIDTH;
+            for (int x = x0; x < x1; x++) {
+                float px = x + 0.5f;
+                if (t.edgeA[0] * px + t.edgeB[0] * py + t.edgeC[0] < 0.0f ||
+                    t.edgeA[1] * px + t.edgeB[1] * py + t.edgeC[1] < 0.0f ||
+                    t.edgeA[2] * px + t.edgeB[2] * py + t.edgeC[2] < 0.0f)
+                    continue;
+                float z = t.depthA * px + t.depthB * py + t.depthC;
+                if (z < row[x])
+                    row[x] = z;
+            }
+        }
+#endif
+    }
+
+    // texels [x0, x1) x [y0, y1) of a level from the 2x2 blocks of the level below
+    void buildLevel(int level, int x0, int y0, int x1, int y1)
+    {
+        int width = levelWidth(level), below = levelWidth(level - 1);
+        const std::vector<float>& maxBelow = maxDepth[level - 1];
+        const std::vector<float>& minBelow = minDepth[level - 1];
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) {
+                size_t a = (size_t)(2 * y) * below + 2 * x, b = a + below;
+                maxDepth[level][(size_t)y * width + x] = std::max(std::max(maxBelow[a], maxBelow[a + 1]), std::max(maxBelow[b], maxBelow[b + 1]));
+                minDepth[level][(size_t)y * width + x] = std::min(std::min(minBelow[a], minBelow[a + 1]), std::min(minBelow[b], minBelow[b + 1]));
+            }
+        }
+    }
+
+    void testRange(const std::vector<unsigned int>& candidates, const FrustumCuller& boxes, const glm::mat4& viewProjection, size_t first, size_t end, std::vector<unsigned int>& visible) const
+    {
+        visible.clear();
+        for (size_t i = first; i < end; i++)
+            if (!occluded(boxes, candidates[i], viewProjection))
+                visible.push_back(candidates[i]);
+    }
+
+    bool occluded(const FrustumCuller& boxes, unsigned int index, const glm::mat4& viewProjection) const
+    {
+        glm::vec4 corners[8];
+        boxCorners(boxes, index, viewProjection, corners);
+
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearest = 1.0f;
+        for (const glm::vec4& corner : corners) {
+            if (corner.w <= 1e-4f || corner.z < -corner.w)
+                return false;   // reaches through the near plane
+            glm::vec3 screen = toScreen(corner);
+            minX = std::min(minX, screen.x); maxX = std::max(maxX, screen.x);
+            minY = std::min(minY, screen.y); maxY = std::max(maxY, screen.y);
+            nearest = std::min(nearest, screen.z);
+        }
+
+        int x0 = std::max(0, (int)std::floor(minX)), x1 = std::min(WIDTH - 1, (int)std::floor(maxX));
+        int y0 = std::max(0, (int)std::floor(minY)), y1 = std::min(HEIGHT - 1, (int)std::floor(maxY));
+        if (x0 > x1 || y0 > y1)
+            return false;   // off screen, that is the frustum culler's call
+
+        // the finest level where the rectangle covers at most 2x2 texels
+        int level = 0;
+        while (level < LEVELS - 1 && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+            level++;
+
+        int width = levelWidth(level);
+        bool hidden = true;
+        for (int y = y0 >> level; y <= (y1 >> level) && hidden; y++) {
+            for (int x = x0 >> level; x <= (x1 >> level); x++) {
+                size_t texel = (size_t)y * width + x;
+                // nearer than everything there: certainly visible
+                if (nearest <= minDepth[level][texel])
+                    return false;
+                if (nearest <= maxDepth[level][texel]) {
+                    hidden = false;
+                    break;
+                }
+            }
+        }
+        return hidden;
+    }
+};
+
+#endif /* hizculler_h */
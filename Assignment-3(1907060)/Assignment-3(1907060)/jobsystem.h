@@ -0,0 +1,232 @@
+#pragma once
+//
+//  jobsystem.h
+//  Work-stealing job system for the per-frame CPU work
+//
+//  A fixed set of worker threads is started once. Every thread, the main
+//  thread included, owns a deque of jobs: it pushes and pops its own jobs
+//  at the back, idle threads steal from the front of the others. Jobs are
+//  ranges of a parallelFor; the thread that started a parallelFor runs the
+//  first range itself and then keeps running jobs (its own or stolen)
+//  until every range is done, so nested parallelFors cannot deadlock.
+//
+//  Nothing here touches OpenGL; jobs only prepare data, the GL calls stay
+//  on the thread that owns the context. Every job is a "job" event in the
+//  frame trace, so the workers show up on its timeline.
+//
+
+#ifndef jobsystem_h
+#define jobsystem_h
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "frametrace.h"
+
+class JobSystem {
+public:
+    ~JobSystem()
+    {
+        stop();
+    }
+
+    // threadCount includes the calling thread, 0 picks one per hardware thread
+    void start(unsigned int threadCount = 0)
+    {
+        stop();
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        queues.clear();
+        for (unsigned int t = 0; t < threadCount; t++)
+            queues.emplace_back(new JobQueue());
+
+        running = true;
+        currentThread() = 0;
+        for (unsigned int t = 1; t < threadCount; t++)
+            workers.emplace_back(&JobSystem::workerLoop, this, t);
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepLock);
+            running = false;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+        workers.clear();
+    }
+
+    // threads that run jobs, the main thread included
+    unsigned int threadCount() const
+    {
+        return (unsigned int)std::max<size_t>(1, queues.size());
+    }
+
+    // ranges a parallelFor over count items splits into: at most 4 per thread, none smaller than grain
+    size_t chunksFor(size_t count, size_t grain) const
+    {
+        size_t byGrain = (count + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1);
+        return std::max<size_t>(1, std::min(byGrain, (size_t)threadCount() * 4));
+    }
+
+    // body(chunk, begin, end) for chunkCount equal ranges of [0, count), returns when all are done
+    template <typename Body>
+    void parallelForChunks(size_t count, size_t chunkCount, const Body& body)
+    {
+        if (count == 0)
+            return;
+        chunkCount = std::max<size_t>(1, std::min(chunkCount, count));
+        if (chunkCount == 1 || workers.empty()) {
+            for (size_t chunk = 0; chunk < chunkCount; chunk++)
+                body(chunk, count * chunk / chunkCount, count * (chunk + 1) / chunkCount);
+            return;
+        }
+
+        std::atomic<size_t> pending(chunkCount - 1);
+        JobQueue& own = *queues[ownQueue()];
+        {
+            std::lock_guard<std::mutex> lock(own.lock);
+            // pushed last to first, so the owner pops them in order
+            for (size_t chunk = chunkCount - 1; chunk >= 1; chunk--)
+                own.jobs.push_back({ &runChunk<Body>, &body, chunk, chunkCount, count, &pending });
+        }
+        queued.fetch_add(chunkCount - 1);
+        {
+            std::lock_guard<std::mutex> lock(sleepLock);
+        }
+        wake.notify_all();
+
+        body(0, 0, count / chunkCount);
+        waitFor(pending);
+    }
+
+    // body(begin, end) over [begin, end) in ranges of at least grain items
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, const Body& body)
+    {
+        if (end <= begin)
+            return;
+        parallelForChunks(end - begin, chunksFor(end - begin, grain), [&](size_t, size_t first, size_t last) {
+            body(begin + first, begin + last);
+        });
+    }
+
+private:
+    struct Job {
+        void (*run)(const void* body, size_t chunk, size_t chunkCount, size_t count);
+        const void* body;
+        size_t chunk;
+        size_t chunkCount;
+        size_t count;
+        std::atomic<size_t>* pending;
+    };
+
+    struct JobQueue {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<JobQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queued{ 0 };
+    bool running = false;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+
+    template <typename Body>
+    static void runChunk(const void* body, size_t chunk, size_t chunkCount, size_t count)
+    {
+        (*(const Body*)body)(chunk, count * chunk / chunkCount, count * (chunk + 1) / chunkCount);
+    }
+
+    // index of the calling thread's queue, threads the system did not start share the main thread's
+    static int& currentThread()
+    {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    size_t ownQueue() const
+    {
+        int index = currentThread();
+        return index >= 0 && (size_t)index < queues.size() ? (size_t)index : 0;
+    }
+
+    bool pop(size_t queue, Job& job)
+    {
+        JobQueue& own = *queues[queue];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (own.jobs.empty())
+            return false;
+        job = own.jobs.back();
+        own.jobs.pop_back();
+        queued.fetch_sub(1);
+        return true;
+    }
+
+    bool steal(size_t thief, Job& job)
+    {
+        for (size_t offset = 1; offset < queues.size(); offset++) {
+            JobQueue& victim = *queues[(thief + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if (victim.jobs.empty())
+                continue;
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    bool runOne(size_t queue)
+    {
+        Job job;
+        if (!pop(queue, job) && !steal(queue, job))
+            return false;
+        TraceScope trace("job");
+        job.run(job.body, job.chunk, job.chunkCount, job.count);
+        job.pending->fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    // helps with any job until pending reaches zero
+    void waitFor(std::atomic<size_t>& pending)
+    {
+        size_t queue = ownQueue();
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (!runOne(queue))
+                std::this_thread::yield();
+        }
+    }
+
+    void workerLoop(unsigned int index)
+    {
+        currentThread() = (int)index;
+        FrameTrace::setThreadName("job worker");
+        for (;;) {
+            if (runOne(index))
+                continue;
+
+            std::unique_lock<std::mutex> lock(sleepLock);
+            wake.wait(lock, [this] { return !running || queued.load() > 0; });
+            if (!running)
+                return;
+        }
+    }
+};
+
+// the one job system of the program, started in main()
+inline JobSystem jobs;
+
+#endif /* jobsystem_h */
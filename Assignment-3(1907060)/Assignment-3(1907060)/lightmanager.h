@@ -0,0 +1,125 @@
+#pragma once
+//
+//  lightmanager.h
+//  Owns every light of the scene and keeps the Lights uniform block in sync
+//
+//  Lights flag themselves dirty when they change; upload() writes only those
+//  lights into the block and sends the changed byte range with one
+//  glBufferSubData, so frames where nothing was toggled cost no GL calls.
+//
+
+#ifndef lightmanager_h
+#define lightmanager_h
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <deque>
+
+#include "uniformbuffers.h"
+#include "pointlight.h"
+#include "spotlight.h"
+#include "directionallight.h"
+#include "shaderpermutations.h"
+
+class LightManager {
+public:
+    // a deque so references handed out by addPointLight() stay valid
+    std::deque<PointLight> pointLights;
+    SpotLight spotLight;
+    DirectionalLight directionalLight;
+    LightsBlock block = {};
+
+    // true if any point light changed in the last upload(), including the ones past the uniform block
+    bool pointLightsChanged = true;
+
+    LightManager(const SpotLight& spot, const DirectionalLight& directional)
+        : spotLight(spot), directionalLight(directional)
+    {
+    }
+
+    PointLight& addPointLight(const PointLight& light)
+    {
+        pointLights.push_back(light);
+        PointLight& added = pointLights.back();
+        added.lightNumber = (int)pointLights.size();
+        added.markDirty();
+        return added;
+    }
+
+    // which lighting shader variant the current switches need
+    unsigned int featureMask() const
+    {
+        unsigned int features = 0;
+        if (directionalLight.on) features |= FEATURE_DIRECTIONAL_LIGHT;
+        if (directionalLight.ambientOn) features |= FEATURE_DIRECTIONAL_AMBIENT;
+        if (directionalLight.diffuseOn) features |= FEATURE_DIRECTIONAL_DIFFUSE;
+        if (directionalLight.specularOn) features |= FEATURE_DIRECTIONAL_SPECULAR;
+        if (spotLight.on) features |= FEATURE_SPOT_LIGHT;
+        return features;
+    }
+
+    int pointLightCount() const
+    {
+        return (int)pointLights.size();
+    }
+
+    void markAllDirty()
+    {
+        for (PointLight& light : pointLights)
+            light.markDirty();
+        spotLight.markDirty();
+        directionalLight.markDirty();
+    }
+
+    // returns true if anything had to be uploaded
+    bool upload(UniformBuffer& lightsUBO)
+    {
+        size_t first = sizeof(LightsBlock), last = 0;
+
+        pointLightsChanged = false;
+        for (size_t i = 0; i < pointLights.size(); i++) {
+            if (!pointLights[i].dirty)
+                continue;
+            pointLightsChanged = true;
+
+            // lights past the block are only read by clustered lighting
+            if (i >= (size_t)MAX_POINT_LIGHTS) {
+                pointLights[i].dirty = false;
+                continue;
+            }
+            pointLights[i].setUpPointLight(block.pointLights[i]);
+            touch(first, last, offsetof(LightsBlock, pointLights) + i * sizeof(PointLightData), sizeof(PointLightData));
+        }
+
+        if (spotLight.dirty) {
+            spotLight.setUpSpotLight(block);
+            touch(first, last, offsetof(LightsBlock, spotLight), sizeof(SpotLightData));
+            touch(first, last, offsetof(LightsBlock, spotLightOn), sizeof(int));
+        }
+
+        if (directionalLight.dirty) {
+            directionalLight.setUpDirectionalLight(block);
+            touch(first, last, offsetof(LightsBlock, directionalLight), sizeof(DirectionalLightData));
+            touch(first, last, offsetof(LightsBlock, directionLightOn), sizeof(int));
+            touch(first, last, offsetof(LightsBlock, ambientLight), 3 * sizeof(int));
+        }
+
+        if (first >= last)
+            return false;
+
+        lightsUBO.update((const char*)&block + first, (GLsizeiptr)(last - first), (GLintptr)first);
+        return true;
+    }
+
+private:
+    static void touch(size_t& first, size_t& last, size_t offset, size_t size)
+    {
+        if (offset < first)
+            first = offset;
+        if (offset + size > last)
+            last = offset + size;
+    }
+};
+
+#endif /* lightmanager_h */
@@ -1,1034 +1,1493 @@
-//
-//  main.cpp
-//  3D Object Drawing
-//
-//  Created by Nazirul Hasan on 4/9/23.
-//  modified by Badiuzzaman on 3/11/24.
-//
-
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "shader.h"
-#include "basic_camera.h"
-#include "camera.h"
-#include "pointLight.h"
-
-
-#include <iostream>
-
-using namespace std;
-
-#define PI 3.14159265359
-
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow* window);
-void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
-void mouse_callback(GLFWwindow* window, double xpos, double ypos);
-void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
-void drawFan(unsigned int VAO, Shader lightingShader, glm::mat4 translateMatrix, glm::mat4 sm);
-int drawAll(Shader lightingShader, unsigned int VAO, glm::mat4 parentTrans);
-void drawCube1(unsigned int& VAO, Shader& lightingShader, glm::mat4 model, glm::vec3 color);
-
-void drawCube(
-    Shader lightingShader, unsigned int VAO, glm::mat4 parentTrans,
-    float posX = 0.0, float posY = 0.0, float posz = 0.0,
-    float rotX = 0.0, float rotY = 0.0, float rotZ = 0.0,
-    float scX = 1.0, float scY = 1.0, float scZ = 1.0,
-    float r = 0.0, float g = 0.0, float b = 0.0);
-
-
-// settings
-const unsigned int SCR_WIDTH = 800;
-const unsigned int SCR_HEIGHT = 600;
-
-//screen
-float lastX = SCR_WIDTH / 2.0f;
-float lastY = SCR_HEIGHT / 2.0f;
-bool firstMouse = true;
-float aspectRatio = 4.0f / 3.0f;
-
-
-//camera
-float eyeX = 1.5, eyeY = 3.8, eyeZ = 10.0;
-float lookAtX = 4.0, lookAtY = 4.0, lookAtZ = 6.0;
-glm::vec3 V = glm::vec3(0.0f, 1.0f, 0.0f);
-BasicCamera basic_camera(eyeX, eyeY, eyeZ, lookAtX, lookAtY, lookAtZ, V);
-Camera camera(glm::vec3(eyeX, eyeY, eyeZ));
-
-// timing
-float deltaTime = 0.0f;    // time between current frame and last frame
-float lastFrame = 0.0f;
-
-bool on = false;
-
-
-bool birdEye = false;
-glm::vec3 cameraPos(1.0f, 2.5f, 3.0f);
-glm::vec3 target(1.0f, 0.0f, 0.0f);
-float birdEyeSpeed = 1.0f;
-
-//rotation around a point
-float theta = 0.0f; // Angle around the Y-axis
-float radius = 2.0f;
-
-//directional light
-bool directionLightOn = true;
-bool directionalAmbient = true;
-bool directionalDiffuse = true;
-bool directionalSpecular = true;
-
-//spot light
-bool spotLightOn = true;
-
-//point light
-bool point1 = true;
-bool point2 = true;
-
-//custom projection matrix
-float fov = glm::radians(camera.Zoom);
-float aspect = (float)SCR_WIDTH / (float)SCR_HEIGHT;
-float near = 0.1f;
-float far = 100.0f;
-float tanHalfFOV = tan(fov / 2.0f);
-
-//positions of the point lights
-glm::vec3 pointLightPositions[] = {
-    glm::vec3(2.0f,  3.0f,  2.0f),
-    glm::vec3(2.0f,  3.0f,  5.0f),
-};
-
-PointLight pointlight1(
-    pointLightPositions[0].x, pointLightPositions[0].y, pointLightPositions[0].z,       // position
-    0.2f, 0.2f, 0.2f,       //ambient
-    0.8f, 0.8f, 0.8f,       //diffuse
-    1.0f, 1.0f, 1.0f,       //specular
-    1.0f,       //k_c
-    0.09f,      //k_l
-    0.032f,     //k_q
-    1       //light number
-);
-
-PointLight pointlight2(
-    pointLightPositions[1].x, pointLightPositions[1].y, pointLightPositions[1].z,
-    0.2f, 0.2f, 0.2f,
-    0.8f, 0.8f, 0.8f,
-    1.0f, 1.0f, 1.0f,
-    1.0f,
-    0.09f,
-    0.032f,
-    2
-);
-
-
-int initGlfw(GLFWwindow*& window) {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    #ifdef __APPLE__
-        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    #endif
-
-    // glfw window creation
-    window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Assignment-3(1907060)", NULL, NULL);
-    if (window == NULL) { cout << "Failed to create GLFW window" << endl; glfwTerminate(); return -1; }
-
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-   // glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetMouseButtonCallback(window, mouse_button_callback);
-    // glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-    // glad: load all OpenGL function pointers
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { cout << "Failed to initialize GLAD" << endl; return -1; }
-
-    // build and compile our shader program
-    return 0;
-}
-
-void safeTerminate(unsigned int& VAO, unsigned int& VBO, unsigned int& EBO) {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    glfwTerminate();
-}
-
-void initBinding(unsigned int& VAO, unsigned int& VBO, unsigned int& EBO, Shader& lightingShader, float* cube_vertices, int verticesSize, unsigned int* cube_indices, int indicesSize) {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-
-    glBufferData(GL_ARRAY_BUFFER, verticesSize, cube_vertices, GL_STATIC_DRAW);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, cube_indices, GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    //normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)12);
-    glEnableVertexAttribArray(1);
-
-    unsigned int lightCubeVAO;
-    glGenVertexArrays(1, &lightCubeVAO);
-    glBindVertexArray(lightCubeVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-
-    //note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    lightingShader.use();
-    lightingShader.setVec3("viewPos", camera.Position);
-
-}
-
-
-int main()
-{
-    GLFWwindow* window = nullptr;
-    if (initGlfw(window)) return -1;
-
-    glEnable(GL_DEPTH_TEST);
-
-
-    //build and compile our shader program
-    Shader lightingShader("vertexShaderForGouraudShading.vs", "fragmentShaderForGouraudShading.fs");
-    Shader ourShader("vertexShader.vs", "fragmentShader.fs");
-    Shader constantShader("vertexShader.vs", "fragmentShaderV2.fs");
-    glm::vec3 color;
-
-
-    // set up vertex data (and buffer(s)) and configure vertex attributes
-    // ------------------------------------------------------------------
-    float cube_vertices[] = {
-        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f,
-        1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f,
-        1.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f,
-        0.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f,
-
-        1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-        1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f,
-        1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f,
-
-        0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-        1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-        1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-
-        0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
-
-        1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f,
-        1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f,
-
-        0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f,
-        1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f,
-        1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f
-    };
-    unsigned int cube_indices[] = {
-        0, 3, 2,
-        2, 1, 0,
-
-        4, 5, 7,
-        7, 6, 4,
-
-        8, 9, 10,
-        10, 11, 8,
-
-        12, 13, 14,
-        14, 15, 12,
-
-        16, 17, 18,
-        18, 19, 16,
-
-        20, 21, 22,
-        22, 23, 20
-    };
-
-    unsigned int VBO, VAO, EBO;
-    initBinding(VAO, VBO, EBO, ourShader, cube_vertices, sizeof(cube_vertices), cube_indices, sizeof(cube_indices));
-
-    unsigned int lightCubeVAO;
-    glGenVertexArrays(1, &lightCubeVAO);
-    glBindVertexArray(lightCubeVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-
-    //note that we update the lamp's position attribute's stride to reflect the updated buffer data
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-
-    float r = 0.0f;
-    while (!glfwWindowShouldClose(window))
-    {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        processInput(window);
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-
-        //pointlight setup
-        pointlight1.setUpPointLight(lightingShader);
-        pointlight2.setUpPointLight(lightingShader);
-
-  
-
-         //spot light set up
-        lightingShader.setVec3("spotLight.position", 4.0f, 4.5f, 6.0f);
-        lightingShader.setVec3("spotLight.direction", 0.0f, -1.0f, 0.0f);
-        lightingShader.setVec3("spotLight.ambient", 0.5f, 0.5f, 0.5f);
-        lightingShader.setVec3("spotLight.diffuse", 0.8f, 0.8f, 0.8f);
-        lightingShader.setVec3("spotLight.specular", 1.0f, 1.0f, 1.0f);
-        lightingShader.setFloat("spotLight.k_c", 1.0f);
-        lightingShader.setFloat("spotLight.k_l", 0.09);
-        lightingShader.setFloat("spotLight.k_q", 0.032);
-        lightingShader.setFloat("spotLight.cos_theta", glm::cos(glm::radians(40.0f)));
-        lightingShader.setBool("spotLightOn", spotLightOn);
-
-
-        //directional light set up
-        lightingShader.setVec3("directionalLight.direction", 0.0f, -1.0f, 0.0f);
-        lightingShader.setVec3("directionalLight.ambient", 0.1f, 0.1f, 0.1f);
-        lightingShader.setVec3("directionalLight.diffuse", 0.8f, 0.8f, 0.8f);
-        lightingShader.setVec3("directionalLight.specular", 1.0f, 1.0f, 1.0f);
-        lightingShader.setBool("directionLightOn", directionLightOn);
-
-        //handle for changes in directional light directly from shedder
-        if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS) {
-            if (directionLightOn) {
-                lightingShader.setBool("ambientLight", !directionalAmbient);
-                directionalAmbient = !directionalAmbient;
-            }
-        }
-
-        if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS) {
-            if (directionLightOn) {
-                lightingShader.setBool("diffuseLight", !directionalDiffuse);
-                directionalDiffuse = !directionalDiffuse;
-            }
-        }
-
-        if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS) {
-            if (directionLightOn) {
-                lightingShader.setBool("specularLight", !directionalSpecular);
-                directionalSpecular = !directionalSpecular;
-            }
-        }
-
-
-
-        glm::mat4 projection(0.0f);
-        projection[0][0] = 1.0f / (aspect * tanHalfFOV);
-        projection[1][1] = 1.0f / tanHalfFOV;
-        projection[2][2] = -(far + near) / (far - near);
-        projection[2][3] = -1.0f;
-        projection[3][2] = -(2.0f * far * near) / (far - near);
- 
-        lightingShader.setMat4("projection", projection);
-
-
-        // camera/view transformation
-        glm::mat4 view;
-
-        if (birdEye) {
-            glm::vec3 up(0.0f, 1.0f, 0.0f);
-            view = glm::lookAt(cameraPos, target, up);
-        }
-        else {
-            view = camera.GetViewMatrix();
-        }
-
-        //glm::mat4 view = basic_camera.createViewMatrix();
-        lightingShader.setMat4("view", view);
-        //constantShader.setMat4("view", view);
-        glm::mat4 identityMatrix = glm::mat4(1.0f);
-        glm::mat4 translateMatrix, rotateXMatrix, rotateYMatrix, rotateZMatrix, scaleMatrix, model, modelCentered, translateMatrixprev;
-        translateMatrix = identityMatrix;
-        glm::vec3 color;
-
-        lightingShader.setVec3("material.emissive", glm::vec3(0.0f, 0.0f, 0.0f));
-        // drawing
-        drawAll(lightingShader, VAO, identityMatrix);
-        //light holder 1 with emissive material property
-        translateMatrix = glm::translate(identityMatrix, glm::vec3(2.08f, 3.5f, 2.08f));
-        scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.04f, -0.5f, 0.04f));
-        model = translateMatrix * scaleMatrix;
-        color = glm::vec3(0.1f, 0.0f, 0.0f);
-
-        lightingShader.setVec3("material.ambient", color);
-        lightingShader.setVec3("material.diffuse", color);
-        lightingShader.setVec3("material.specular", color);
-        lightingShader.setVec3("material.emissive", color);
-        lightingShader.setFloat("material.shininess", 32.0f);
-
-        lightingShader.setMat4("model", model);
-
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        lightingShader.use();
-        lightingShader.setVec3("viewPos", camera.Position);
-
-        //light holder 2 with emissive material property
-        translateMatrix = glm::translate(identityMatrix, glm::vec3(2.08f, 3.5f, 5.08f));
-        scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.04f, -0.5f, 0.04f));
-        model = translateMatrix * scaleMatrix;
-        color = glm::vec3(0.2f, 0.3f, 0.1f);
-
-        lightingShader.setVec3("material.ambient", color);
-        lightingShader.setVec3("material.diffuse", color);
-        lightingShader.setVec3("material.specular", color);
-        lightingShader.setVec3("material.emissive", color);
-        lightingShader.setFloat("material.shininess", 32.0f);
-
-        lightingShader.setMat4("model", model);
-
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        //draw the lamp object(s)
-        ourShader.use();
-        ourShader.setMat4("projection", projection);
-        ourShader.setMat4("view", view);
-        glBindVertexArray(lightCubeVAO);
-
-        //we now draw as many light bulbs as we have point lights.
-        
-        for (unsigned int i = 0; i < 2; i++)
-        {
-            translateMatrix = glm::translate(identityMatrix, pointLightPositions[i]);
-            scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.2f, -0.2f, 0.2f));
-            model = translateMatrix * scaleMatrix;
-            ourShader.setMat4("model", model);
-            ourShader.setVec4("color", glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        }
-   
-
-        
-        // drawing above
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteVertexArrays(1, &lightCubeVAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-
-    //glfw terminate, clearing all previously allocated GLFW resources
-    glfwTerminate();
-    return 0;
-    
-}
-
-float r = 0.0f;
-
-int drawAll(Shader lightingShader, unsigned int VAO, glm::mat4 identityMatrix) {
-    // floor
-   drawCube(lightingShader, VAO, identityMatrix, 0, 0, 0, 0, 0, 0, 6, .1, 6, 0.76, 0.57, 0.37);
-   
-  
-      // ceiling
-    drawCube(lightingShader, VAO, identityMatrix, 0, 5, 0, 0, 0, 0, 6, .1, 6, 1.0, 0.99, 0.82);
-
-    // right wall
-    drawCube(lightingShader, VAO, identityMatrix, 0, .1, -.05, 0, 0, 0, 6, 5, .1, 0.678, 0.847, 0.902);
-    // left wall
-    drawCube(lightingShader, VAO, identityMatrix, -0.05, .1, 0, 0, 0, 0, .1, 5, 6, 0.678, 0.847, 0.902);
-
-    // right shelf
-    drawCube(lightingShader, VAO, identityMatrix, 0.1, 1.5, .1, 0, 0, 0, 4, .1, 1.2, 1.0, 0.99, 0.82);
-    // left shelf
-    drawCube(lightingShader, VAO, identityMatrix, 0.1, 1.5, .1, 0, 0, 0, 1.2, .1, 5.9, 1.0, 0.99, 0.82);
-
-    // left wall shelf
-    int total = 4;
-    for (int i = 0; i < total; i++) {
-        float gap = (1 / 10.0);
-        float width = .8;
-
-        drawCube(lightingShader, VAO, identityMatrix, 0, 2.5, (i * width + i * gap),
-            0, 0, 0, .6, 1, width, 0.70, 0.45, 0.56
-        );
-
-        if (i == total - 1) continue;
-        drawCube(lightingShader, VAO, identityMatrix, 0, 2.5, (i * width + i * gap) + width,
-            0, 0, 0, .6, 1, gap, 1.0, 0.99, 0.82
-        );
-    }
-    // right wall shelf
-    drawCube(lightingShader, VAO, identityMatrix, .65, 2.5, 0, 0, 0, 0, .8, 1, .6, 0.70, 0.45, 0.56);
-    // right wall shelf white
-    drawCube(lightingShader, VAO, identityMatrix, .65, 2.55, .6, 0, 0, 0, .7, .9, .05, 0.99, 0.99, 0.99);
-
-    // right wall window?
-    drawCube(lightingShader, VAO, identityMatrix, 2, 2, .1, 0, 0, 0, 2, 1.5, .1, 0.70, 0.45, 0.56);
-    // right wall window? white
-    drawCube(lightingShader, VAO, identityMatrix, 2.05, 2.05, .15, 0, 0, 0, .9, 1.4, .1, 0.99, 0.99, 0.99);
-    drawCube(lightingShader, VAO, identityMatrix, 3.05, 2.05, .15, 0, 0, 0, .9, 1.4, .1, 0.99, 0.99, 0.99);
-
-    // lower shelf left
-    total = 6;
-    for (int i = 0; i < total; i++) {
-        float gap = (1 / 10.0);
-        float width = .8;
-
-        drawCube(lightingShader, VAO, identityMatrix, 0, 0, .5 + (i * width + i * gap),
-            0, 0, 0, 1.2, 1.5, width, 0.70, 0.45, 0.56
-        );
-
-        if (i == total - 1) continue;
-        drawCube(lightingShader, VAO, identityMatrix, 0, 0, .5 + (i * width + i * gap) + width,
-            0, 0, 0, 1.2, 1.5, gap, 0.99, 0.99, 0.99
-        );
-    }
-
-    // right wall shelf bottom
-    total = 4;
-    for (int i = 0; i < total; i++) {
-        float gap = (1 / 10.0);
-        float width = .6;
-
-        drawCube(lightingShader, VAO, identityMatrix, 1.2 + (i * width + i * gap), 0, 0,
-            0, 0, 0, width, 1.5, 1.2, 0.70, 0.45, 0.56
-        );
-
-        if (i == total - 1) continue;
-        drawCube(lightingShader, VAO, identityMatrix, 1.2 + (i * width + i * gap + width), 0, 0,
-            0, 0, 0, gap, 1.5, 1.2, 0.99, 0.99, 0.99
-        );
-    }
-
-    // refrigerator
-    drawCube(lightingShader, VAO, identityMatrix, 4, 0, 0, 0, 0, 0, 2, 3.5, 1.5, 0.70, 0.45, 0.56);
-    drawCube(lightingShader, VAO, identityMatrix, 4.05, 0, 1.5, 0, 0, 0, .95, 3.5, .05, 0.99, 0.99, 0.99);
-    drawCube(lightingShader, VAO, identityMatrix, 5.05, 0, 1.5, 0, 0, 0, .95, 3.5, .05, 0.99, 0.99, 0.99);
-    // refrigerator handle
-    drawCube(lightingShader, VAO, identityMatrix, 4.9, 1.5, 1.55, 0, 0, 0, .05, 1.1, .05, 20 / 255.0, 20 / 255.0, 20 / 255.0);
-    drawCube(lightingShader, VAO, identityMatrix, 5.1, 1.5, 1.55, 0, 0, 0, .05, 1.1, .05, 20 / 255.0, 20 / 255.0, 20 / 255.0);
-
-    // table-top
-    drawCube(lightingShader, VAO, identityMatrix, 3, 1.5, 4, 0, 0, 0, 2, .1, 1.5, 0.70, 0.45, 0.56);
-    // left top leg
-    drawCube(lightingShader, VAO, identityMatrix, 3, 0, 4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
-    // right top leg
-    drawCube(lightingShader, VAO, identityMatrix, 4.9, 0, 4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
-    // left bottom leg
-    drawCube(lightingShader, VAO, identityMatrix, 3, 0, 5.4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
-    // right bottom leg
-    drawCube(lightingShader, VAO, identityMatrix, 4.9, 0, 5.4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
-
-    for (int z = 0; z < 2; z++) {
-        for (int x = 0; x < 2; x++) {
-            float width = 0.5;
-            float gap = 0.4;
-            int zz = (z == 0) ? 1 : 0;
-
-            // chairs
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.2, .8, (z * 2 + 3), 0, 0, 0, .5, .1, .5, 0.70, 0.10, 0.17);
-            // left top leg
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.2, 0, (z * 2 + 3), 0, 0, 0, .1, (.8 + zz * .7), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
-
-
-            // left left leg
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.33, 0.9, (z * 2 + 3 + .5 * z - z * .1), 0, 0, 0, .05, .6, .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
-            // left mid leg
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.44, 0.9, (z * 2 + 3 + .5 * z - z * .1), 0, 0, 0, .05, .6, .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
-            // left right leg
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.55, 0.9, (z * 2 + 3 + .5 * z - z * .1), 0, 0, 0, .05, .6, .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
-
-
-            // right top leg
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.6, 0, (z * 2 + 3), 0, 0, 0, .1, (.8 + .7 * zz), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
-
-            zz = !zz;
-            // left bottom leg
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.2, 0, (z * 2 + 3.4), 0, 0, 0, .1, (.8 + .7 * zz), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
-            // right bottom leg
-            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.6, 0, (z * 2 + 3.4), 0, 0, 0, .1, (.8 + .7 * zz), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
-        }
-    }
-
-    //sink
-    drawCube(lightingShader, VAO, identityMatrix, 2, 1.6, .1, 0, 0, 0, 1.5, .02, 1.3, 24 / 255.0, 21 / 255.0, 22 / 255.0);
-    total = 20;
-    float unit = (1.3 / (2 * total));
-    for (int z = 0; z < total; z++) {
-        drawCube(lightingShader, VAO, identityMatrix, 2, 1.63, (z + 1) * 2 * unit, 0, 0, 0, 1, .01, unit / 2, 60 / 255.0, 60 / 255.0, 60 / 255.0);
-    }
-
-
-
-
-    //// the real tap
-    drawCube(lightingShader, VAO, identityMatrix, 3.2, 1.6, .3, 0, 0, 0, .05, .5, .05, 200 / 255.0, 200 / 255.0, 200 / 255.0);
-    drawCube(lightingShader, VAO, identityMatrix, 3.2, 2.1, .3, 0, 0, 0, .05, .05, .3, 200 / 255.0, 200 / 255.0, 200 / 255.0);
-    drawCube(lightingShader, VAO, identityMatrix, 3.2, 2.0, .6, 0, 0, 0, .05, .2, .05, 200 / 255.0, 200 / 255.0, 200 / 255.0);
-
-    // oven
-    drawCube(lightingShader, VAO, identityMatrix, 0.1, 1.6, 4, 0, 0, 0, .8, .5, 1.2, 154 / 255.0, 134 / 255.0, 108 / 255.0);
-    drawCube(lightingShader, VAO, identityMatrix, 0.9, 1.6, 4.35, 0, 0, 0, .01, .5, .8, 20 / 255.0, 20 / 255.0, 20 / 255.0);
-
-    total = 15;
-    unit = (.5 / (2 * total));
-    for (int z = 0; z < total; z++) {
-        drawCube(lightingShader, VAO, identityMatrix, 0.9, 1.6 + (z + 1) * 2 * unit, 4.05, 0, 0, 0, .01, unit / 4, .3, 255 / 255.0, 255 / 255.0, 255 / 255.0);
-    }
-
-    // fan, 6, 5, 6
-    //on = true;
-    if (on) {
-        r += 1;
-    }
-    else
-    {
-        r = 0.0f;
-    }
-
-    glm::mat4 translateMatrix, scaleMatrix, model, translateMatrixprev, rotateYMatrix;
-    //fan stick
-    translateMatrix = glm::translate(identityMatrix, glm::vec3(3.0, 4.0, 3.0));
-    scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.1f, 0.9f, 0.1));
-    model = translateMatrix * scaleMatrix;
-    lightingShader.setMat4("model", model);
-    lightingShader.setVec4("color", glm::vec4(0.0, 0.0, 0.0, 1.0));
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-    // fan rotation
-    translateMatrixprev = translateMatrix;
-    glm::mat4 translateMatrix2, translateMatrixBack, test;
-
-    translateMatrix2 = glm::translate(identityMatrix, glm::vec3(3.025, 4.0, 3.025));
-    translateMatrixBack = glm::translate(identityMatrix, glm::vec3(-3.025, -4.0, -3.02));
-    rotateYMatrix = glm::rotate(identityMatrix, glm::radians(r), glm::vec3(0.0, 1.0, 0.0));
-    model = translateMatrixBack * rotateYMatrix * translateMatrix2;
-    drawFan(VAO, lightingShader, translateMatrix, rotateYMatrix);
-
-
-    return 0;
-}
-
-void drawFan(unsigned int VAO, Shader ourShader, glm::mat4 translateMatrix, glm::mat4 sm)
-{
-    glm::mat4 identityMatrix = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-    glm::mat4 rotateXMatrix, rotateYMatrix, rotateZMatrix, scaleMatrix, model, modelCentered, translateMatrixprev;
-    glm::mat4 middleTranslate, leftBladeTranslate, frontBladeTranslate, rightBladeTranslate, backBladeTranslate;
-    //fan middle part
-    //translateMatrix = translateMatrix * glm::translate(identityMatrix, glm::vec3(-0.2, -1.5, -0.2));
-    middleTranslate = glm::translate(identityMatrix, glm::vec3(-0.2, 0.0, -0.2));
-    scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.5f, -0.1f, 0.5));
-    model = translateMatrix * sm * middleTranslate * scaleMatrix;
-    ourShader.setMat4("model", model);
-    ourShader.setVec4("shapeColor", glm::vec4(0.27, 0.12, 0.13, 1.0));
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-    translateMatrixprev = translateMatrix;
-    //left fan
-    //translateMatrix = translateMatrix * glm::translate(identityMatrix, glm::vec3(0.0, -0.075, 0.0));
-    leftBladeTranslate = glm::translate(identityMatrix, glm::vec3(-0.2, 0.0, -0.2));
-    scaleMatrix = glm::scale(identityMatrix, glm::vec3(-2.0f, -0.1f, 0.5));
-    model = translateMatrix * sm * leftBladeTranslate * scaleMatrix;
-    ourShader.setMat4("model", model);
-    ourShader.setVec4("shapeColor", glm::vec4(0.27, 0.12, 0.13, 1.0));
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-    //front fan
-    //translateMatrix = translateMatrixprev * glm::translate(identityMatrix, glm::vec3(0.0, -0.075, 0.5));
-    frontBladeTranslate = glm::translate(identityMatrix, glm::vec3(-0.2, 0.0, 0.3));
-    scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.5f, -0.1f, 2.0));
-    model = translateMatrix * sm * frontBladeTranslate * scaleMatrix;
-    ourShader.setMat4("model", model);
-    ourShader.setVec4("shapeColor", glm::vec4(0.27, 0.12, 0.13, 1.0));
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-    //right fan
-    //translateMatrix = translateMatrix * glm::translate(identityMatrix, glm::vec3(0.5, 0.0, 0.0));
-    rightBladeTranslate = glm::translate(identityMatrix, glm::vec3(0.25, 0.0, 0.25));
-    scaleMatrix = glm::scale(identityMatrix, glm::vec3(2.0f, -0.1f, -0.5));
-    model = translateMatrix * sm * rightBladeTranslate * scaleMatrix;
-    ourShader.setMat4("model", model);
-    ourShader.setVec4("shapeColor", glm::vec4(0.27, 0.12, 0.13, 1.0));
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-    //back fan
-    //translateMatrix = translateMatrix * glm::translate(identityMatrix, glm::vec3(0.0, 0.0, -0.5));
-    backBladeTranslate = glm::translate(identityMatrix, glm::vec3(0.25, 0.0, -0.25));
-    scaleMatrix = glm::scale(identityMatrix, glm::vec3(-0.5f, -0.1f, -2.0));
-    model = translateMatrix * sm * backBladeTranslate * scaleMatrix;
-    ourShader.setMat4("model", model);
-    ourShader.setVec4("shapeColor", glm::vec4(0.27, 0.12, 0.13, 1.0));
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-}
-
-void drawCube1(unsigned int& VAO, Shader& lightingShader, glm::mat4 model, glm::vec3 color)
-{
-    //use the shadder
-    lightingShader.use();
-    //color = glm::vec3(0.624f, 0.416f, 0.310f);
-
-    //define lighting properties
-    lightingShader.setVec3("material.ambient", color);
-    lightingShader.setVec3("material.diffuse", color);
-    lightingShader.setVec3("material.specular", color);
-    lightingShader.setFloat("material.shininess", 32.0f);
-
-    lightingShader.setMat4("model", model);
-
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-}
-
-
-
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-// ---------------------------------------------------------------------------------------------
-void framebuffer_size_callback(GLFWwindow* window, int width, int height)
-{
-    //make sure the viewport matches the new window dimensions; note that width and height will be significantly larger than specified on retina displays.
-    float aspectRatio = 4.0f / 3.0f;
-    int viewWidth, viewHeight;
-
-    if (width / (float)height > aspectRatio) {
-        //Window is too wide, fit height and adjust width
-        viewHeight = height;
-        viewWidth = (int)(height * aspectRatio);
-    }
-    else {
-        //Window is too tall, fit width and adjust height
-        viewWidth = width;
-        viewHeight = (int)(width / aspectRatio);
-    }
-
-    //Center the viewport
-    int xOffset = (width - viewWidth) / 2;
-    int yOffset = (height - viewHeight) / 2;
-
-    glViewport(xOffset, yOffset, viewWidth, viewHeight);
-    //glViewport(0, 0, width, height);
-}
-
-
-// Track whether the mouse button is pressed
-bool isMousePressed = false;
-
-void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
-    if (button == GLFW_MOUSE_BUTTON_LEFT) {
-        if (action == GLFW_PRESS) {
-            firstMouse = true;
-            isMousePressed = true;
-        }
-        else if (action == GLFW_RELEASE) {
-            isMousePressed = false;
-        }
-    }
-}
-
-void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
-{
-    float xpos = static_cast<float>(xposIn);
-    float ypos = static_cast<float>(yposIn);
-
-    if (firstMouse)
-    {
-        lastX = xpos;
-        lastY = ypos;
-        firstMouse = false;
-    }
-
-    float xoffset = xpos - lastX;
-    float yoffset = lastY - ypos;       //reversed since y-coordinates go from bottom to top
-
-    lastX = xpos;
-    lastY = ypos;
-
-    camera.ProcessMouseMovement(xoffset, yoffset);
-}
-
-
-// glfw: whenever the mouse scroll wheel scrolls, this callback is called
-// ----------------------------------------------------------------------
-void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-    camera.ProcessMouseScroll(static_cast<float>(yoffset));
-}
-
-
-// If you are confused with it's usage, then pass an identity matrix to it, and everything will be fine 
-void drawCube(Shader shaderProgram, unsigned int VAO, glm::mat4 parentTrans,
-    float posX, float posY, float posZ,
-    float rotX, float rotY, float rotZ,
-    float scX, float scY, float scZ,
-    float r, float g, float b) {
-
-
-    //int colorLoc = glGetUniformLocation(shaderProgram.ID, "shapeColor");
-    //glUniform3f(colorLoc, 1.0f, 0.0f, 1.0f);
-    //glUniform3fv(colorLoc, 1, glm::value_ptr(glm::vec3(r, g, b)));
-
-    shaderProgram.use();
-    glm::vec3 color = glm::vec3(r, g, b);
-    glm::mat4 translateMatrix, rotateXMatrix, rotateYMatrix, rotateZMatrix, scaleMatrix, model, modelCentered;
-    translateMatrix = glm::translate(parentTrans, glm::vec3(posX, posY, posZ));
-    rotateXMatrix = glm::rotate(translateMatrix, glm::radians(rotX), glm::vec3(1.0f, 0.0f, 0.0f));
-    rotateYMatrix = glm::rotate(rotateXMatrix, glm::radians(rotY), glm::vec3(0.0f, 1.0f, 0.0f));
-    rotateZMatrix = glm::rotate(rotateYMatrix, glm::radians(rotZ), glm::vec3(0.0f, 0.0f, 1.0f));
-    model = glm::scale(rotateZMatrix, glm::vec3(scX, scY, scZ));
-    //modelCentered = glm::translate(model, glm::vec3(-0.25, -0.25, -0.25));
-
-    //define lighting properties
-    shaderProgram.setVec3("material.ambient", color);
-    shaderProgram.setVec3("material.diffuse", color);
-    shaderProgram.setVec3("material.specular", color);
-    shaderProgram.setFloat("material.shininess", 32.0f);
-
-    shaderProgram.setMat4("model", model);
-
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-}
-
-
-
-void processInput(GLFWwindow* window)
-{
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-
-    if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) on = true;
-    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) on = false;
-
-
-
-
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(FORWARD, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(BACKWARD, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(LEFT, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(RIGHT, deltaTime);
-    }
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(UP, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(DOWN, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(P_UP, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(P_DOWN, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(Y_LEFT, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(Y_RIGHT, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(R_LEFT, deltaTime);
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS) {
-        if (!birdEye)
-            camera.ProcessKeyboard(R_RIGHT, deltaTime);
-    }
-    if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS)
-    {
-        eyeX += 2.5 * deltaTime;
-        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
-    }
-    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
-    {
-        eyeX -= 2.5 * deltaTime;
-        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
-    }
-  /*  if (glfwGetKey(window, GLFW_KEY_U) == GLFW_PRESS)
-    {
-        eyeZ += 2.5 * deltaTime;
-        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
-    }*/
-    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS)
-    {
-        eyeZ -= 2.5 * deltaTime;
-        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
-    }
-  /*  if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
-    {
-        eyeY += 2.5 * deltaTime;
-        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
-    }*/
-   /* if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS)
-    {
-        eyeY -= 2.5 * deltaTime;
-        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
-    }*/
-
-    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS) {
-        birdEye = !birdEye;
-    }
-
-    if (birdEye) {
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-            cameraPos.z -= birdEyeSpeed * deltaTime; // Move forward along Z
-            target.z -= birdEyeSpeed * deltaTime;
-            if (cameraPos.z <= 2.0) {
-                cameraPos.z = 2.0;
-            }
-            if (target.z <= -4.0) {
-                target.z = -4.0;
-            }
-        }
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-            cameraPos.z += birdEyeSpeed * deltaTime; // Move backward along Z
-            target.z += birdEyeSpeed * deltaTime;
-            if (cameraPos.z >= 13.5) {
-                cameraPos.z = 13.5;
-            }
-            if (target.z >= 7.5) {
-                target.z = 7.5;
-            }
-        }
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
-    {
-        if (!birdEye) {
-            theta += 0.01f;
-            camera.Position.x = lookAtX + radius * sin(theta);
-            camera.Position.y = lookAtY;
-            camera.Position.z = lookAtZ + radius * cos(theta);
-        }
-    }
-    if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) {
-        directionLightOn = !directionLightOn;
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS) {
-        spotLightOn = !spotLightOn;
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) {
-        if (pointlight1.ambientOn > 0 && pointlight1.diffuseOn > 0 && pointlight1.specularOn > 0) {
-            pointlight1.turnOff();
-            point1 = false;
-        }
-        else {
-            pointlight1.turnOn();
-            point1 = true;
-        }
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) {
-        if (pointlight2.ambientOn > 0 && pointlight2.diffuseOn > 0 && pointlight2.specularOn > 0) {
-            pointlight2.turnOff();
-            point2 = false;
-        }
-        else {
-            pointlight2.turnOn();
-            point2 = true;
-        }
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS) {
-        if (pointlight1.ambientOn > 0 || pointlight2.ambientOn > 0) {
-            if (point1)
-                pointlight1.turnAmbientOff();
-            if (point2)
-                pointlight2.turnAmbientOff();
-        }
-        else {
-            if (point1)
-                pointlight1.turnAmbientOn();
-            if (point2)
-                pointlight2.turnAmbientOn();
-        }
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS) {
-        if (pointlight1.diffuseOn > 0 || pointlight2.diffuseOn > 0) {
-            if (point1)
-                pointlight1.turnDiffuseOff();
-            if (point2)
-                pointlight2.turnDiffuseOff();
-        }
-        else {
-            if (point1)
-                pointlight1.turnDiffuseOn();
-            if (point2)
-                pointlight2.turnDiffuseOn();
-        }
-    }
-
-    if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS) {
-        if (pointlight1.specularOn > 0 || pointlight2.specularOn > 0) {
-            if (point1)
-                pointlight1.turnSpecularOff();
-            if (point2)
-                pointlight2.turnSpecularOff();
-        }
-        else {
-            if (point1)
-                pointlight1.turnSpecularOn();
-            if (point2)
-                pointlight2.turnSpecularOn();
-        }
-    }
-}
+//
+//  main.cpp
+//  3D Object Drawing
+//
+//  Created by Nazirul Hasan on 4/9/23.
+//  modified by Badiuzzaman on 3/11/24.
+//
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "shader.h"
+#include "basic_camera.h"
+#include "camera.h"
+#include "pointLight.h"
+#include "lightmanager.h"
+#include "cubebatch.h"
+#include "staticmesh.h"
+#include "uniformbuffers.h"
+#include "normalmatrix.h"
+#include "shaderpermutations.h"
+#include "clusteredlights.h"
+#include "renderqueue.h"
+#include "frustumculler.h"
+#include "occlusionculler.h"
+#include "hizculler.h"
+#include "gpuculler.h"
+#include "glextensions.h"
+#include "ringbuffer.h"
+#include "scenefile.h"
+#include "scenegraph.h"
+#include "batchtransform.h"
+#include "jobsystem.h"
+#include "fixedtimestep.h"
+#include "framebenchmark.h"
+#include "profiler.h"
+#include "shadercompileworker.h"
+
+
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+
+#define PI 3.14159265359
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void processInput(GLFWwindow* window);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+void buildCeilingFan(int parent);
+void tickCeilingFan();
+void animateCeilingFan(float alpha);
+int drawAll(Shader& lightingShader, unsigned int VAO, glm::mat4 parentTrans);
+void drawStaticScene(Shader& lightingShader, unsigned int VAO, glm::mat4 identityMatrix);
+void drawRooms(Shader& lightingShader, unsigned int VAO);
+void drawCeilingFan(Shader& lightingShader, unsigned int VAO);
+void drawCube1(unsigned int& VAO, Shader& lightingShader, glm::mat4 model, glm::vec3 color);
+
+void drawCube(
+    Shader& lightingShader, unsigned int VAO, glm::mat4 parentTrans,
+    float posX = 0.0, float posY = 0.0, float posz = 0.0,
+    float rotX = 0.0, float rotY = 0.0, float rotZ = 0.0,
+    float scX = 1.0, float scY = 1.0, float scZ = 1.0,
+    float r = 0.0, float g = 0.0, float b = 0.0);
+void emitCube(Shader& lightingShader, unsigned int VAO, const glm::mat4& model, const glm::vec3& color, float shininess = 32.0f);
+
+
+// settings
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+//screen
+float lastX = SCR_WIDTH / 2.0f;
+float lastY = SCR_HEIGHT / 2.0f;
+bool firstMouse = true;
+float aspectRatio = 4.0f / 3.0f;
+
+
+//camera
+float eyeX = 1.5, eyeY = 3.8, eyeZ = 10.0;
+float lookAtX = 4.0, lookAtY = 4.0, lookAtZ = 6.0;
+glm::vec3 V = glm::vec3(0.0f, 1.0f, 0.0f);
+BasicCamera basic_camera(eyeX, eyeY, eyeZ, lookAtX, lookAtY, lookAtZ, V);
+Camera camera(glm::vec3(eyeX, eyeY, eyeZ));
+
+// timing
+float deltaTime = 0.0f;    // time between current frame and last frame
+float lastFrame = 0.0f;
+
+bool on = false;
+
+
+bool birdEye = false;
+
+//how the static part of the scene is drawn
+enum StaticDrawMode {
+    DRAW_PER_CUBE,
+    DRAW_INSTANCED,
+    DRAW_BAKED,
+    DRAW_GPU_DRIVEN     //culled by a compute shader, one glMultiDrawElementsIndirect, needs GL 4.3
+};
+StaticDrawMode staticDrawMode = DRAW_BAKED;
+CubeBatch staticBatch;
+StaticMesh staticMesh;
+
+//individual draws are queued and issued sorted by program, VAO and material
+RenderQueue renderQueue;
+
+//per-frame uniform data (camera, per-draw objects) is streamed through this ring
+RingBuffer frameRing;
+
+//frustum culling of the static cubes and of everything in the render queue
+bool frustumCulling = true;
+FrustumCuller staticCuller;
+
+//occlusion queries for the static cubes, their results are used one frame late
+bool occlusionCulling = false;
+bool occlusionQueriesIssued = false;     //last frame, results older than a skipped frame are dropped
+OcclusionCuller occlusionCuller;
+vector<unsigned int> allStaticCubes;
+vector<unsigned int> unoccludedStaticCubes;
+
+//occlusion culling on the CPU against the large static boxes, no queries and no latency
+bool hizCulling = false;
+HiZCuller hizCuller;
+vector<unsigned int> hizVisibleStaticCubes;
+
+//frustum culling and drawing of the static cubes without the CPU, in DRAW_GPU_DRIVEN
+GpuCuller gpuCuller;
+
+//the static kitchen is repeated on a roomGrid x roomGrid grid for stress scenes
+int roomGrid = 1;
+const float ROOM_SPACING = 7.0f;
+
+//static cubes mapped from a scene file (--scene) replace the built-in kitchen
+SceneFile sceneFile;
+//while set, drawCube() only records its arguments, see --export-scene
+SceneWriter* sceneExport = nullptr;
+//the built-in kitchen recorded the same way at start, drawRooms() composes it like a scene file
+SceneWriter builtInKitchen;
+//one translation per room and the model matrices of every static cube of every room, refilled by drawRooms()
+vector<glm::mat4> roomMatrices;
+vector<glm::mat4> roomModels;
+
+//transform hierarchy of the moving parts, world matrices are cached and only the fan's are refreshed
+SceneGraph sceneGraph;
+struct CeilingFan {
+    int rotor = SceneGraph::NO_PARENT;  //its local matrix is the spin
+    float angle = 0.0f;                 //degrees at the last simulation tick
+    float previousAngle = 0.0f;         //degrees at the tick before
+    float renderedAngle = 0.0f;         //degrees the rotor matrix was built for
+    std::vector<int> parts;             //nodes drawn as fan cubes
+} ceilingFan;
+
+//animation advances in fixed 60 Hz ticks whatever the render rate, rendering interpolates between the last two
+FixedTimestep simulationClock(1.0 / 60.0);
+
+//--headless renders into this target instead of the window, --benchmark times a scripted run
+OffscreenTarget offscreenTarget;
+FrameBenchmark frameBenchmark;
+
+//--trace writes the frame timeline here at exit and on F12
+string tracePath;
+glm::vec3 cameraPos(1.0f, 2.5f, 3.0f);
+glm::vec3 target(1.0f, 0.0f, 0.0f);
+float birdEyeSpeed = 1.0f;
+
+//rotation around a point
+float theta = 0.0f; // Angle around the Y-axis
+float radius = 2.0f;
+
+//point light
+bool point1 = true;
+bool point2 = true;
+
+//clustered lighting, evaluates only the point lights that reach a vertex
+bool clusteredLighting = false;
+ClusteredLights clusteredLights;
+
+//custom projection matrix
+float fov = glm::radians(camera.Zoom);
+float aspect = (float)SCR_WIDTH / (float)SCR_HEIGHT;
+float near = 0.1f;
+float far = 100.0f;
+float tanHalfFOV = tan(fov / 2.0f);
+
+//positions of the point lights
+glm::vec3 pointLightPositions[] = {
+    glm::vec3(2.0f,  3.0f,  2.0f),
+    glm::vec3(2.0f,  3.0f,  5.0f),
+};
+
+//all lights live in the light manager, it uploads them only when they change
+LightManager lightManager(
+    SpotLight(
+        4.0f, 4.5f, 6.0f,       //position
+        0.0f, -1.0f, 0.0f,      //direction
+        0.5f, 0.5f, 0.5f,       //ambient
+        0.8f, 0.8f, 0.8f,       //diffuse
+        1.0f, 1.0f, 1.0f,       //specular
+        1.0f,       //k_c
+        0.09f,      //k_l
+        0.032f,     //k_q
+        40.0f       //cut-off angle
+    ),
+    DirectionalLight(
+        0.0f, -1.0f, 0.0f,      //direction
+        0.1f, 0.1f, 0.1f,       //ambient
+        0.8f, 0.8f, 0.8f,       //diffuse
+        1.0f, 1.0f, 1.0f        //specular
+    )
+);
+SpotLight& spotLight = lightManager.spotLight;
+DirectionalLight& directionalLight = lightManager.directionalLight;
+
+PointLight& pointlight1 = lightManager.addPointLight(PointLight(
+    pointLightPositions[0].x, pointLightPositions[0].y, pointLightPositions[0].z,       // position
+    0.2f, 0.2f, 0.2f,       //ambient
+    0.8f, 0.8f, 0.8f,       //diffuse
+    1.0f, 1.0f, 1.0f,       //specular
+    1.0f,       //k_c
+    0.09f,      //k_l
+    0.032f,     //k_q
+    1       //light number
+));
+
+PointLight& pointlight2 = lightManager.addPointLight(PointLight(
+    pointLightPositions[1].x, pointLightPositions[1].y, pointLightPositions[1].z,
+    0.2f, 0.2f, 0.2f,
+    0.8f, 0.8f, 0.8f,
+    1.0f, 1.0f, 1.0f,
+    1.0f,
+    0.09f,
+    0.032f,
+    2
+));
+
+
+int initGlfw(GLFWwindow*& window, bool visible = true) {
+    glfwInit();
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+
+    //4.5 enables the GPU-driven mode, everything else only needs 3.3
+    const int contextVersions[2][2] = { { 4, 5 }, { 3, 3 } };
+    for (const int* version : contextVersions) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        #ifdef __APPLE__
+            glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        #endif
+
+        // glfw window creation
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Assignment-3(1907060)", NULL, NULL);
+        if (window != NULL) break;
+    }
+    if (window == NULL) { cout << "Failed to create GLFW window" << endl; glfwTerminate(); return -1; }
+
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+   // glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    // glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: load all OpenGL function pointers
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { cout << "Failed to initialize GLAD" << endl; return -1; }
+    loadGLExtensions((GLExtLoadProc)glfwGetProcAddress);
+    cout << "OpenGL " << glext.major << "." << glext.minor << (glext.gpuDrivenSupported() ? "" : ", GPU-driven mode unavailable") << endl;
+
+    // build and compile our shader program
+    return 0;
+}
+
+void safeTerminate(unsigned int& VAO, unsigned int& VBO, unsigned int& EBO) {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glfwTerminate();
+}
+
+void initBinding(unsigned int& VAO, unsigned int& VBO, unsigned int& EBO, float* cube_vertices, int verticesSize, unsigned int* cube_indices, int indicesSize) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    glBufferData(GL_ARRAY_BUFFER, verticesSize, cube_vertices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, cube_indices, GL_STATIC_DRAW);
+
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    //normal attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)12);
+    glEnableVertexAttribArray(1);
+
+    unsigned int lightCubeVAO;
+    glGenVertexArrays(1, &lightCubeVAO);
+    glBindVertexArray(lightCubeVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    //note that we update the lamp's position attribute's stride to reflect the updated buffer data
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+}
+
+
+//spreads extra dim lamps on a grid under the ceiling, to stress clustered lighting
+void addStressLamps(int count)
+{
+    int perRow = (int)ceil(sqrt((float)count));
+    float spacing = 0.5f;
+    for (int i = 0; i < count; i++) {
+        float x = 0.25f + (i % perRow) * spacing;
+        float z = 0.25f + (i / perRow) * spacing;
+        lightManager.addPointLight(PointLight(
+            x, 4.5f, z,
+            0.01f, 0.01f, 0.01f,
+            0.05f, 0.05f, 0.05f,
+            0.05f, 0.05f, 0.05f,
+            1.0f,
+            1.4f,
+            7.2f,
+            0
+        ));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    //--lamps N adds N extra point lights and switches to clustered lighting
+    //--rooms N repeats the kitchen N x N times
+    //--scene file draws the static cubes of a scene file instead of the built-in kitchen
+    //--export-scene file writes the built-in kitchen as a scene file and quits
+    //--threads N runs the frame preparation jobs on N threads, the main thread included
+    //--vsync 0 renders uncapped, --vsync 1 waits for every vertical blank
+    //--headless renders into an offscreen framebuffer of a hidden window, for machines without a display
+    //--benchmark N renders N frames along a scripted camera path and writes their CPU and GPU times
+    //--benchmark-out file takes the results, .csv for CSV, JSON otherwise
+    //--draw-mode per-cube|instanced|baked|gpu picks how the static cubes are drawn at start
+    //--profile times the named scopes of a frame on the CPU and GPU and prints them every second, after the startup time
+    //--no-shader-cache compiles every program from source instead of loading the binaries saved by earlier runs
+    //--sync-shaders compiles every program before the first frame instead of in the background
+    //--trace file records a timeline of the frame's scopes and jobs, written as Chrome trace JSON at exit and on F12
+    string exportScenePath;
+    unsigned int threadCount = 0;
+    int swapInterval = -1;
+    bool headless = false;
+    int benchmarkFrames = 0;
+    string benchmarkPath = "benchmark.json";
+    string drawMode;
+    bool asyncShaders = true;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--headless")
+            headless = true;
+        else if (string(argv[i]) == "--profile")
+            profiler.enabled = profiler.printReports = true;
+        else if (string(argv[i]) == "--no-shader-cache")
+            programCache.enabled = false;
+        else if (string(argv[i]) == "--sync-shaders")
+            asyncShaders = false;
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--lamps") {
+            addStressLamps(atoi(argv[i + 1]));
+            clusteredLighting = true;
+        }
+        else if (string(argv[i]) == "--rooms") {
+            roomGrid = max(1, atoi(argv[i + 1]));
+        }
+        else if (string(argv[i]) == "--scene") {
+            sceneFile.open(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--export-scene") {
+            exportScenePath = argv[i + 1];
+        }
+        else if (string(argv[i]) == "--threads") {
+            threadCount = (unsigned int)max(1, atoi(argv[i + 1]));
+        }
+        else if (string(argv[i]) == "--vsync") {
+            swapInterval = max(0, atoi(argv[i + 1]));
+        }
+        else if (string(argv[i]) == "--benchmark") {
+            benchmarkFrames = max(1, atoi(argv[i + 1]));
+        }
+        else if (string(argv[i]) == "--benchmark-out") {
+            benchmarkPath = argv[i + 1];
+        }
+        else if (string(argv[i]) == "--draw-mode") {
+            drawMode = argv[i + 1];
+        }
+        else if (string(argv[i]) == "--trace") {
+            tracePath = argv[i + 1];
+        }
+    }
+    //nothing would ever be seen of a headless run, so it always benchmarks
+    if (headless && benchmarkFrames == 0)
+        benchmarkFrames = 300;
+
+    FrameTrace::setThreadName("main");
+    frameTrace.recording = !tracePath.empty();
+
+    //culling, clustering and instance packing run as jobs, GL calls stay on this thread
+    jobs.start(threadCount);
+
+    GLFWwindow* window = nullptr;
+    if (initGlfw(window, !headless)) return -1;
+    //a benchmark measures the renderer, not the display's refresh rate
+    if (swapInterval < 0 && benchmarkFrames > 0)
+        swapInterval = 0;
+    if (swapInterval >= 0)
+        glfwSwapInterval(swapInterval);
+    if (headless) {
+        if (!offscreenTarget.create(SCR_WIDTH, SCR_HEIGHT)) { glfwTerminate(); return -1; }
+        offscreenTarget.bind();
+    }
+    //without KHR_parallel_shader_compile a second, hidden context sharing our objects compiles on its own thread
+    if (asyncShaders && !glext.parallelShaderCompileSupported()) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow* compileWindow = glfwCreateWindow(1, 1, "shader compiler", NULL, window);
+        if (compileWindow != NULL)
+            shaderCompileWorker.start([compileWindow](bool current) { glfwMakeContextCurrent(current ? compileWindow : NULL); });
+    }
+
+    glEnable(GL_DEPTH_TEST);
+
+
+    //build and compile our shader program
+    //programs only start compiling here, each one blocks the first time it is used, see shader.h
+    ShaderCompileMode compileMode = asyncShaders ? COMPILE_DEFERRED : COMPILE_NOW;
+    Shader ourShader("vertexShader.vs", "fragmentShader.fs", {}, compileMode);
+    Shader constantShader("vertexShader.vs", "fragmentShaderV2.fs", {}, compileMode);
+    //the lighting shader is specialized per light switch combination, see shaderpermutations.h;
+    //the fallbacks go first so they are linked by the first frame, the variants replace them as they finish
+    ShaderPermutations lightingShaders("vertexShaderForGouraudShading.vs", "fragmentShaderForGouraudShading.fs");
+    lightingShaders.mode = compileMode;
+    if (asyncShaders) {
+        lightingShaders.prepareFallback(clusteredLighting, lightManager.pointLightCount());
+        lightingShaders.prepareFallback(!clusteredLighting, lightManager.pointLightCount());
+        lightingShaders.prepareAll(clusteredLighting, lightManager.pointLightCount());
+        lightingShaders.prepareAll(!clusteredLighting, lightManager.pointLightCount());
+    }
+    glm::vec3 color;
+
+    if (!exportScenePath.empty()) {
+        SceneWriter writer;
+        sceneExport = &writer;
+        drawStaticScene(ourShader, 0, glm::mat4(1.0f));
+        sceneExport = nullptr;
+
+        bool written = writer.write(exportScenePath.c_str());
+        if (written)
+            cout << "exported " << writer.size() << " cubes to " << exportScenePath << endl;
+        shaderCompileWorker.stop();
+        glfwTerminate();
+        return written ? 0 : -1;
+    }
+    if (!sceneFile.isOpen()) {
+        sceneExport = &builtInKitchen;
+        drawStaticScene(ourShader, 0, glm::mat4(1.0f));
+        sceneExport = nullptr;
+    }
+
+    //camera and light uniform blocks, shared by every program through fixed binding points
+    bindSharedUniformBlocks(ourShader);
+    bindSharedUniformBlocks(constantShader);
+
+    UniformBuffer cameraUBO, lightsUBO;
+    cameraUBO.create(sizeof(CameraBlock), CAMERA_BLOCK_BINDING);
+    lightsUBO.create(sizeof(LightsBlock), LIGHTS_BLOCK_BINDING);
+    CameraBlock cameraBlock = {};
+
+    GLint uniformOffsetAlignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformOffsetAlignment);
+    frameRing.create(64 * 1024, uniformOffsetAlignment);
+    renderQueue.ring = &frameRing;
+
+    clusteredLights.create();
+
+
+    // set up vertex data (and buffer(s)) and configure vertex attributes
+    // ------------------------------------------------------------------
+    float cube_vertices[] = {
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f,
+        1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f,
+        0.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f,
+
+        1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f,
+        1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f,
+
+        0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+
+        0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
+
+        1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+        1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+
+        0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f,
+        1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f, -1.0f, 0.0f
+    };
+    unsigned int cube_indices[] = {
+        0, 3, 2,
+        2, 1, 0,
+
+        4, 5, 7,
+        7, 6, 4,
+
+        8, 9, 10,
+        10, 11, 8,
+
+        12, 13, 14,
+        14, 15, 12,
+
+        16, 17, 18,
+        18, 19, 16,
+
+        20, 21, 22,
+        22, 23, 20
+    };
+
+    unsigned int VBO, VAO, EBO;
+    initBinding(VAO, VBO, EBO, cube_vertices, sizeof(cube_vertices), cube_indices, sizeof(cube_indices));
+
+    unsigned int lightCubeVAO;
+    glGenVertexArrays(1, &lightCubeVAO);
+    glBindVertexArray(lightCubeVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+    //note that we update the lamp's position attribute's stride to reflect the updated buffer data
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    //record the static part of the scene once into the instance buffer
+    staticBatch.attach(VAO);
+    staticBatch.begin();
+    drawRooms(lightingShaders.get(lightManager.featureMask(), lightManager.pointLightCount()), VAO);
+    staticBatch.end();
+
+    //world boxes of the recorded cubes, in the same order as the instances and the baked mesh
+    staticCuller.reserve(staticBatch.instances.size());
+    for (const CubeInstance& instance : staticBatch.instances)
+        staticCuller.addCube(instance.model);
+    for (unsigned int i = 0; i < staticCuller.size(); i++)
+        allStaticCubes.push_back(i);
+    occlusionCuller.create(staticCuller.size());
+    hizCuller.selectOccluders(staticCuller);
+    gpuCuller.create(staticCuller, 36);
+
+    //and bake the same cubes into one pre-transformed vertex buffer
+    staticMesh.bake(staticBatch.instances, cube_vertices, 24, cube_indices, 36);
+
+    //the moving parts go into the scene graph, under the kitchen's root
+    int kitchenNode = sceneGraph.addNode(SceneGraph::NO_PARENT, glm::mat4(1.0f));
+    buildCeilingFan(kitchenNode);
+
+
+    //the benchmark times drawAll() unless another mode is asked for
+    if (benchmarkFrames > 0)
+        staticDrawMode = DRAW_PER_CUBE;
+    if (drawMode == "per-cube") staticDrawMode = DRAW_PER_CUBE;
+    else if (drawMode == "instanced") staticDrawMode = DRAW_INSTANCED;
+    else if (drawMode == "baked") staticDrawMode = DRAW_BAKED;
+    else if (drawMode == "gpu" && gpuCuller.available()) staticDrawMode = DRAW_GPU_DRIVEN;
+    if (benchmarkFrames > 0)
+        frameBenchmark.start(benchmarkFrames, benchmarkPath);
+
+    float r = 0.0f;
+    float lastTitleUpdate = 0.0f;
+    bool benchmarkWritten = true;
+    bool firstFrame = true;
+    while (!glfwWindowShouldClose(window))
+    {
+        TraceScope frameScope("frame");
+        float currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        //reads the GPU scope times of a few frames ago, their queries are done by now
+        if (profiler.enabled)
+            profiler.beginFrame();
+
+        //a benchmark frame is exactly one simulation tick and ignores input, so every run renders the same frames
+        if (frameBenchmark.active()) {
+            deltaTime = (float)simulationClock.tickSeconds();
+            frameBenchmark.beginFrame();
+        }
+        else {
+            ProfileScope inputScope("input", false);
+            processInput(window);
+        }
+
+        //waits for the GPU to release the ring region this frame writes into
+        frameRing.beginFrame();
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+
+        //light setup, only lights toggled since the last frame are uploaded
+        {
+            ProfileScope lightScope("lights");
+            lightManager.upload(lightsUBO);
+        }
+
+        //program variant without the disabled lights compiled in
+        unsigned int lightFeatures = lightManager.featureMask();
+        if (clusteredLighting)
+            lightFeatures |= FEATURE_CLUSTERED_LIGHTS;
+        Shader& lightingShader = lightingShaders.get(lightFeatures, lightManager.pointLightCount());
+
+
+
+        glm::mat4 projection(0.0f);
+        projection[0][0] = 1.0f / (aspect * tanHalfFOV);
+        projection[1][1] = 1.0f / tanHalfFOV;
+        projection[2][2] = -(far + near) / (far - near);
+        projection[2][3] = -1.0f;
+        projection[3][2] = -(2.0f * far * near) / (far - near);
+
+
+        // camera/view transformation
+        glm::mat4 view;
+        glm::vec3 viewPos = camera.Position;
+
+        if (frameBenchmark.active()) {
+            CameraPose pose = frameBenchmark.pose();
+            view = glm::lookAt(pose.position, pose.target, glm::vec3(0.0f, 1.0f, 0.0f));
+            viewPos = pose.position;
+        }
+        else if (birdEye) {
+            glm::vec3 up(0.0f, 1.0f, 0.0f);
+            view = glm::lookAt(cameraPos, target, up);
+        }
+        else {
+            view = camera.GetViewMatrix();
+        }
+
+        //glm::mat4 view = basic_camera.createViewMatrix();
+
+        //one upload for the camera of every program
+        cameraBlock.projection = projection;
+        cameraBlock.view = view;
+        cameraBlock.viewPos = viewPos;
+        RingAllocation cameraData;
+        if (frameRing.allocate(sizeof(CameraBlock), cameraData)) {
+            memcpy(cameraData.data, &cameraBlock, sizeof(CameraBlock));
+            frameRing.commit(cameraData);
+            glBindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, frameRing.ID, cameraData.offset, sizeof(CameraBlock));
+        }
+        else {
+            cameraUBO.update(&cameraBlock, sizeof(CameraBlock));
+            glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, cameraUBO.ID);
+        }
+
+        //bin the point lights into the clusters of this view
+        if (clusteredLighting) {
+            ProfileScope clusterScope("light clusters");
+            clusteredLights.update(lightManager.pointLights, lightManager.pointLightsChanged, view, near, far, tanHalfFOV, aspect);
+            clusteredLights.bind(lightingShader);
+        }
+
+        renderQueue.begin(view, projection, far);
+        renderQueue.culling = frustumCulling;
+
+        //static cubes inside the frustum, minus the ones the last available queries found hidden
+        bool cpuStaticCulling = staticDrawMode == DRAW_BAKED || staticDrawMode == DRAW_INSTANCED;
+        const vector<unsigned int>* staticCandidates = &allStaticCubes;
+        if (frustumCulling && cpuStaticCulling) {
+            staticCuller.cull(extractFrustum(projection * view));
+            staticCandidates = &staticCuller.visible;
+        }
+        if (hizCulling && cpuStaticCulling) {
+            glm::mat4 viewProjection = projection * view;
+            hizCuller.render(staticCuller, viewProjection);
+            hizCuller.test(*staticCandidates, staticCuller, viewProjection, hizVisibleStaticCubes);
+            staticCandidates = &hizVisibleStaticCubes;
+        }
+        const vector<unsigned int>* staticVisible = staticCandidates;
+        bool occlusionActive = occlusionCulling && cpuStaticCulling;
+        if (occlusionActive && !occlusionQueriesIssued)
+            occlusionCuller.invalidate();
+        occlusionQueriesIssued = occlusionActive;
+        if (occlusionActive) {
+            occlusionCuller.filter(*staticCandidates, staticCuller, birdEye ? cameraPos : viewPos, near, unoccludedStaticCubes);
+            staticVisible = &unoccludedStaticCubes;
+        }
+
+        glm::mat4 identityMatrix = glm::mat4(1.0f);
+        glm::mat4 translateMatrix, rotateXMatrix, rotateYMatrix, rotateZMatrix, scaleMatrix, model, modelCentered, translateMatrixprev;
+        translateMatrix = identityMatrix;
+        glm::vec3 color;
+
+        lightingShader.use();
+        lightingShader.setVec3("material.emissive", glm::vec3(0.0f, 0.0f, 0.0f));
+        //the simulation catches up in whole ticks, the render pose lies between the last two
+        {
+            ProfileScope simulationScope("simulation", false);
+            int ticks = simulationClock.advance(deltaTime);
+            for (int t = 0; t < ticks; t++)
+                tickCeilingFan();
+            animateCeilingFan(simulationClock.alpha());
+
+            //only the subtrees whose local matrices changed get new world matrices
+            sceneGraph.update();
+        }
+
+        // drawing
+        if (staticDrawMode == DRAW_PER_CUBE) {
+            drawAll(lightingShader, VAO, identityMatrix);
+        }
+        else {
+            {
+                ProfileScope roomScope("static room");
+                if (staticDrawMode == DRAW_BAKED)
+                    staticMesh.draw(lightingShader, *staticVisible);
+                else if (staticDrawMode == DRAW_INSTANCED)
+                    staticBatch.draw(lightingShader, VAO, *staticVisible);
+                else
+                    gpuCuller.draw(lightingShader, VAO, staticBatch, projection * view, frustumCulling);
+            }
+            ProfileScope fanScope("fan", false);
+            drawCeilingFan(lightingShader, VAO);
+        }
+        //the lamp pass only queues its cubes, they are drawn by the render queue
+        {
+            ProfileScope lampScope("lamps", false);
+            //light holder 1 with emissive material property
+            translateMatrix = glm::translate(identityMatrix, glm::vec3(2.08f, 3.5f, 2.08f));
+            scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.04f, -0.5f, 0.04f));
+            model = translateMatrix * scaleMatrix;
+            color = glm::vec3(0.1f, 0.0f, 0.0f);
+            renderQueue.submit(lightingShader, VAO, model, solidMaterial(color, color));
+
+            //light holder 2 with emissive material property
+            translateMatrix = glm::translate(identityMatrix, glm::vec3(2.08f, 3.5f, 5.08f));
+            scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.04f, -0.5f, 0.04f));
+            model = translateMatrix * scaleMatrix;
+            color = glm::vec3(0.2f, 0.3f, 0.1f);
+            renderQueue.submit(lightingShader, VAO, model, solidMaterial(color, color));
+
+            //draw the lamp object(s)
+            //we now draw as many light bulbs as we have point lights.
+
+            for (unsigned int i = 0; i < 2; i++)
+            {
+                translateMatrix = glm::translate(identityMatrix, pointLightPositions[i]);
+                scaleMatrix = glm::scale(identityMatrix, glm::vec3(0.2f, -0.2f, 0.2f));
+                model = translateMatrix * scaleMatrix;
+                renderQueue.submit(ourShader, lightCubeVAO, model, solidMaterial(glm::vec3(1.0f, 1.0f, 1.0f)));
+            }
+        }
+
+        //everything submitted above, sorted so each program, VAO and material is set once
+        {
+            ProfileScope queueScope("render queue");
+            renderQueue.flush();
+        }
+
+        //proxy boxes against the finished depth buffer, read back next frame
+        if (occlusionActive) {
+            ProfileScope queryScope("occlusion queries");
+            occlusionCuller.issueQueries(*staticCandidates, staticCuller, ourShader, lightCubeVAO);
+        }
+
+        //culling counters in the title bar, twice a second
+        if (currentFrame - lastTitleUpdate > 0.5f) {
+            lastTitleUpdate = currentFrame;
+            string title = "Assignment-3(1907060) | static cubes drawn " + to_string(staticVisible->size()) + "/" + to_string(allStaticCubes.size());
+            if (staticDrawMode == DRAW_GPU_DRIVEN)
+                title = "Assignment-3(1907060) | static cubes culled on the GPU";
+            //both only run while the static cubes are culled on the CPU, otherwise their counters are from an earlier frame
+            if (hizCulling && cpuStaticCulling)
+                title += " | hi-z culled " + to_string(hizCuller.stats.culled) + " (" + to_string(hizCuller.stats.rasterMs + hizCuller.stats.testMs) + " ms)";
+            if (occlusionActive)
+                title += " | occluded " + to_string(occlusionCuller.stats.culled) + " | queries pending " + to_string(occlusionCuller.stats.pending);
+            glfwSetWindowTitle(window, title.c_str());
+        }
+   
+
+        
+        // drawing above
+
+        frameRing.endFrame();
+
+        if (frameBenchmark.active()) {
+            frameBenchmark.endFrame();
+            if (frameBenchmark.finished()) {
+                benchmarkWritten = frameBenchmark.writeResults();
+                glfwSetWindowShouldClose(window, true);
+            }
+        }
+        {
+            ProfileScope swapScope("swap", false);
+            glfwSwapBuffers(window);
+        }
+        //startup time, the lighting variants of the first frame included
+        if (firstFrame && profiler.printReports) {
+            firstFrame = false;
+            cout << "first frame after " << (int)(glfwGetTime() * 1000.0) << " ms";
+            if (programCache.active())
+                cout << " | program binaries loaded " << programCache.hits << ", compiled " << programCache.misses << ", rejected " << programCache.rejected;
+            cout << endl;
+        }
+        {
+            ProfileScope eventScope("events", false);
+            glfwPollEvents();
+        }
+
+        if (profiler.enabled)
+            profiler.endFrame(glfwGetTime());
+    }
+    //the worker finishes the programs still queued first, nothing waits on them forever
+    shaderCompileWorker.stop();
+    staticBatch.release();
+    staticMesh.release();
+    cameraUBO.release();
+    frameRing.release();
+    frameBenchmark.release();
+    profiler.release();
+    offscreenTarget.release();
+    lightingShaders.release();
+    clusteredLights.release();
+    occlusionCuller.release();
+    gpuCuller.release();
+    lightsUBO.release();
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &lightCubeVAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+
+    jobs.stop();
+    if (frameTrace.recording)
+        frameTrace.write(tracePath);
+
+    //glfw terminate, clearing all previously allocated GLFW resources
+    glfwTerminate();
+    return benchmarkWritten ? 0 : -1;
+    
+}
+
+int drawAll(Shader& lightingShader, unsigned int VAO, glm::mat4 identityMatrix) {
+    //both only queue their cubes, the GPU time shows up under "render queue"
+    {
+        ProfileScope roomScope("static room", false);
+        drawRooms(lightingShader, VAO);
+    }
+    ProfileScope fanScope("fan", false);
+    drawCeilingFan(lightingShader, VAO);
+
+    return 0;
+}
+
+// the static scene once per room of the room grid, the first room is the original kitchen
+void drawRooms(Shader& lightingShader, unsigned int VAO) {
+    roomMatrices.clear();
+    for (int x = 0; x < roomGrid; x++)
+        for (int z = 0; z < roomGrid; z++)
+            roomMatrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * ROOM_SPACING, 0.0f, z * ROOM_SPACING)));
+
+    //the matrices of all rooms are composed on the job threads, the cubes are then emitted in order on this one
+    SceneArrays cubes = sceneFile.isOpen() ? sceneFile.arrays() : builtInKitchen.arrays();
+    composeSceneCubes(cubes, roomMatrices.data(), roomMatrices.size(), roomModels);
+    for (size_t i = 0; i < roomModels.size(); i++) {
+        const SceneMaterial& material = cubes.materials[cubes.materialIndices[i % cubes.count]];
+        emitCube(lightingShader, VAO, roomModels[i], material.color, material.shininess);
+    }
+}
+
+// everything in the kitchen except the fan, it never moves so it can be recorded once into a CubeBatch
+void drawStaticScene(Shader& lightingShader, unsigned int VAO, glm::mat4 identityMatrix) {
+    // floor
+   drawCube(lightingShader, VAO, identityMatrix, 0, 0, 0, 0, 0, 0, 6, .1, 6, 0.76, 0.57, 0.37);
+   
+  
+      // ceiling
+    drawCube(lightingShader, VAO, identityMatrix, 0, 5, 0, 0, 0, 0, 6, .1, 6, 1.0, 0.99, 0.82);
+
+    // right wall
+    drawCube(lightingShader, VAO, identityMatrix, 0, .1, -.05, 0, 0, 0, 6, 5, .1, 0.678, 0.847, 0.902);
+    // left wall
+    drawCube(lightingShader, VAO, identityMatrix, -0.05, .1, 0, 0, 0, 0, .1, 5, 6, 0.678, 0.847, 0.902);
+
+    // right shelf
+    drawCube(lightingShader, VAO, identityMatrix, 0.1, 1.5, .1, 0, 0, 0, 4, .1, 1.2, 1.0, 0.99, 0.82);
+    // left shelf
+    drawCube(lightingShader, VAO, identityMatrix, 0.1, 1.5, .1, 0, 0, 0, 1.2, .1, 5.9, 1.0, 0.99, 0.82);
+
+    // left wall shelf
+    int total = 4;
+    for (int i = 0; i < total; i++) {
+        float gap = (1 / 10.0);
+        float width = .8;
+
+        drawCube(lightingShader, VAO, identityMatrix, 0, 2.5, (i * width + i * gap),
+            0, 0, 0, .6, 1, width, 0.70, 0.45, 0.56
+        );
+
+        if (i == total - 1) continue;
+        drawCube(lightingShader, VAO, identityMatrix, 0, 2.5, (i * width + i * gap) + width,
+            0, 0, 0, .6, 1, gap, 1.0, 0.99, 0.82
+        );
+    }
+    // right wall shelf
+    drawCube(lightingShader, VAO, identityMatrix, .65, 2.5, 0, 0, 0, 0, .8, 1, .6, 0.70, 0.45, 0.56);
+    // right wall shelf white
+    drawCube(lightingShader, VAO, identityMatrix, .65, 2.55, .6, 0, 0, 0, .7, .9, .05, 0.99, 0.99, 0.99);
+
+    // right wall window?
+    drawCube(lightingShader, VAO, identityMatrix, 2, 2, .1, 0, 0, 0, 2, 1.5, .1, 0.70, 0.45, 0.56);
+    // right wall window? white
+    drawCube(lightingShader, VAO, identityMatrix, 2.05, 2.05, .15, 0, 0, 0, .9, 1.4, .1, 0.99, 0.99, 0.99);
+    drawCube(lightingShader, VAO, identityMatrix, 3.05, 2.05, .15, 0, 0, 0, .9, 1.4, .1, 0.99, 0.99, 0.99);
+
+    // lower shelf left
+    total = 6;
+    for (int i = 0; i < total; i++) {
+        float gap = (1 / 10.0);
+        float width = .8;
+
+        drawCube(lightingShader, VAO, identityMatrix, 0, 0, .5 + (i * width + i * gap),
+            0, 0, 0, 1.2, 1.5, width, 0.70, 0.45, 0.56
+        );
+
+        if (i == total - 1) continue;
+        drawCube(lightingShader, VAO, identityMatrix, 0, 0, .5 + (i * width + i * gap) + width,
+            0, 0, 0, 1.2, 1.5, gap, 0.99, 0.99, 0.99
+        );
+    }
+
+    // right wall shelf bottom
+    total = 4;
+    for (int i = 0; i < total; i++) {
+        float gap = (1 / 10.0);
+        float width = .6;
+
+        drawCube(lightingShader, VAO, identityMatrix, 1.2 + (i * width + i * gap), 0, 0,
+            0, 0, 0, width, 1.5, 1.2, 0.70, 0.45, 0.56
+        );
+
+        if (i == total - 1) continue;
+        drawCube(lightingShader, VAO, identityMatrix, 1.2 + (i * width + i * gap + width), 0, 0,
+            0, 0, 0, gap, 1.5, 1.2, 0.99, 0.99, 0.99
+        );
+    }
+
+    // refrigerator
+    drawCube(lightingShader, VAO, identityMatrix, 4, 0, 0, 0, 0, 0, 2, 3.5, 1.5, 0.70, 0.45, 0.56);
+    drawCube(lightingShader, VAO, identityMatrix, 4.05, 0, 1.5, 0, 0, 0, .95, 3.5, .05, 0.99, 0.99, 0.99);
+    drawCube(lightingShader, VAO, identityMatrix, 5.05, 0, 1.5, 0, 0, 0, .95, 3.5, .05, 0.99, 0.99, 0.99);
+    // refrigerator handle
+    drawCube(lightingShader, VAO, identityMatrix, 4.9, 1.5, 1.55, 0, 0, 0, .05, 1.1, .05, 20 / 255.0, 20 / 255.0, 20 / 255.0);
+    drawCube(lightingShader, VAO, identityMatrix, 5.1, 1.5, 1.55, 0, 0, 0, .05, 1.1, .05, 20 / 255.0, 20 / 255.0, 20 / 255.0);
+
+    // table-top
+    drawCube(lightingShader, VAO, identityMatrix, 3, 1.5, 4, 0, 0, 0, 2, .1, 1.5, 0.70, 0.45, 0.56);
+    // left top leg
+    drawCube(lightingShader, VAO, identityMatrix, 3, 0, 4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
+    // right top leg
+    drawCube(lightingShader, VAO, identityMatrix, 4.9, 0, 4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
+    // left bottom leg
+    drawCube(lightingShader, VAO, identityMatrix, 3, 0, 5.4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
+    // right bottom leg
+    drawCube(lightingShader, VAO, identityMatrix, 4.9, 0, 5.4, 0, 0, 0, .1, 1.5, .1, 0.99, 0.99, 0.99);
+
+    for (int z = 0; z < 2; z++) {
+        for (int x = 0; x < 2; x++) {
+            float width = 0.5;
+            float gap = 0.4;
+            int zz = (z == 0) ? 1 : 0;
+
+            // chairs
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.2, .8, (z * 2 + 3), 0, 0, 0, .5, .1, .5, 0.70, 0.10, 0.17);
+            // left top leg
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.2, 0, (z * 2 + 3), 0, 0, 0, .1, (.8 + zz * .7), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
+
+
+            // left left leg
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.33, 0.9, (z * 2 + 3 + .5 * z - z * .1), 0, 0, 0, .05, .6, .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
+            // left mid leg
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.44, 0.9, (z * 2 + 3 + .5 * z - z * .1), 0, 0, 0, .05, .6, .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
+            // left right leg
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.55, 0.9, (z * 2 + 3 + .5 * z - z * .1), 0, 0, 0, .05, .6, .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
+
+
+            // right top leg
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.6, 0, (z * 2 + 3), 0, 0, 0, .1, (.8 + .7 * zz), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
+
+            zz = !zz;
+            // left bottom leg
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.2, 0, (z * 2 + 3.4), 0, 0, 0, .1, (.8 + .7 * zz), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
+            // right bottom leg
+            drawCube(lightingShader, VAO, identityMatrix, (width + gap) * x + 3.6, 0, (z * 2 + 3.4), 0, 0, 0, .1, (.8 + .7 * zz), .1, 75 / 255.0, 62 / 255.0, 53 / 255.0);
+        }
+    }
+
+    //sink
+    drawCube(lightingShader, VAO, identityMatrix, 2, 1.6, .1, 0, 0, 0, 1.5, .02, 1.3, 24 / 255.0, 21 / 255.0, 22 / 255.0);
+    total = 20;
+    float unit = (1.3 / (2 * total));
+    for (int z = 0; z < total; z++) {
+        drawCube(lightingShader, VAO, identityMatrix, 2, 1.63, (z + 1) * 2 * unit, 0, 0, 0, 1, .01, unit / 2, 60 / 255.0, 60 / 255.0, 60 / 255.0);
+    }
+
+
+
+
+    //// the real tap
+    drawCube(lightingShader, VAO, identityMatrix, 3.2, 1.6, .3, 0, 0, 0, .05, .5, .05, 200 / 255.0, 200 / 255.0, 200 / 255.0);
+    drawCube(lightingShader, VAO, identityMatrix, 3.2, 2.1, .3, 0, 0, 0, .05, .05, .3, 200 / 255.0, 200 / 255.0, 200 / 255.0);
+    drawCube(lightingShader, VAO, identityMatrix, 3.2, 2.0, .6, 0, 0, 0, .05, .2, .05, 200 / 255.0, 200 / 255.0, 200 / 255.0);
+
+    // oven
+    drawCube(lightingShader, VAO, identityMatrix, 0.1, 1.6, 4, 0, 0, 0, .8, .5, 1.2, 154 / 255.0, 134 / 255.0, 108 / 255.0);
+    drawCube(lightingShader, VAO, identityMatrix, 0.9, 1.6, 4.35, 0, 0, 0, .01, .5, .8, 20 / 255.0, 20 / 255.0, 20 / 255.0);
+
+    total = 15;
+    unit = (.5 / (2 * total));
+    for (int z = 0; z < total; z++) {
+        drawCube(lightingShader, VAO, identityMatrix, 0.9, 1.6 + (z + 1) * 2 * unit, 4.05, 0, 0, 0, .01, unit / 4, .3, 255 / 255.0, 255 / 255.0, 255 / 255.0);
+    }
+}
+
+// stick, hub and blades as scene graph nodes; the blades hang below the rotor, whose local matrix is the spin
+void buildCeilingFan(int parent) {
+    glm::mat4 identityMatrix = glm::mat4(1.0f);
+
+    // fan, 6, 5, 6
+    int fanNode = sceneGraph.addNode(parent, glm::translate(identityMatrix, glm::vec3(3.0, 4.0, 3.0)));
+
+    //fan stick
+    ceilingFan.parts.push_back(sceneGraph.addNode(fanNode, glm::scale(identityMatrix, glm::vec3(0.1f, 0.9f, 0.1))));
+
+    // fan rotation
+    ceilingFan.rotor = sceneGraph.addNode(fanNode, identityMatrix);
+    ceilingFan.angle = ceilingFan.previousAngle = ceilingFan.renderedAngle = 0.0f;
+
+    //fan middle part
+    ceilingFan.parts.push_back(sceneGraph.addNode(ceilingFan.rotor,
+        glm::translate(identityMatrix, glm::vec3(-0.2, 0.0, -0.2)) * glm::scale(identityMatrix, glm::vec3(0.5f, -0.1f, 0.5))));
+    //left fan
+    ceilingFan.parts.push_back(sceneGraph.addNode(ceilingFan.rotor,
+        glm::translate(identityMatrix, glm::vec3(-0.2, 0.0, -0.2)) * glm::scale(identityMatrix, glm::vec3(-2.0f, -0.1f, 0.5))));
+    //front fan
+    ceilingFan.parts.push_back(sceneGraph.addNode(ceilingFan.rotor,
+        glm::translate(identityMatrix, glm::vec3(-0.2, 0.0, 0.3)) * glm::scale(identityMatrix, glm::vec3(0.5f, -0.1f, 2.0))));
+    //right fan
+    ceilingFan.parts.push_back(sceneGraph.addNode(ceilingFan.rotor,
+        glm::translate(identityMatrix, glm::vec3(0.25, 0.0, 0.25)) * glm::scale(identityMatrix, glm::vec3(2.0f, -0.1f, -0.5))));
+    //back fan
+    ceilingFan.parts.push_back(sceneGraph.addNode(ceilingFan.rotor,
+        glm::translate(identityMatrix, glm::vec3(0.25, 0.0, -0.25)) * glm::scale(identityMatrix, glm::vec3(-0.5f, -0.1f, -2.0))));
+}
+
+// one simulation tick of the spin, a degree per tick is the speed the fan had at 60 frames per second
+void tickCeilingFan() {
+    ceilingFan.previousAngle = ceilingFan.angle;
+    //on = true;
+    if (on) {
+        ceilingFan.angle += 1.0f;
+    }
+    else
+    {
+        ceilingFan.angle = ceilingFan.previousAngle = 0.0f;
+    }
+
+    //both angles wrap together, so the interpolation never sweeps back across the circle
+    if (ceilingFan.previousAngle >= 360.0f) {
+        ceilingFan.angle -= 360.0f;
+        ceilingFan.previousAngle -= 360.0f;
+    }
+}
+
+// render pose between the last two ticks, the rotor subtree is only marked dirty when it moved
+void animateCeilingFan(float alpha) {
+    float angle = ceilingFan.previousAngle + (ceilingFan.angle - ceilingFan.previousAngle) * alpha;
+    if (angle != ceilingFan.renderedAngle) {
+        ceilingFan.renderedAngle = angle;
+        sceneGraph.setLocal(ceilingFan.rotor, glm::rotate(glm::mat4(1.0f), glm::radians(angle), glm::vec3(0.0, 1.0, 0.0)));
+    }
+}
+
+void drawCeilingFan(Shader& lightingShader, unsigned int VAO) {
+    //fan material, the same white it used to pick up from the last cube of the scene
+    Material fanMaterial = solidMaterial(glm::vec3(1.0f, 1.0f, 1.0f));
+
+    for (int node : ceilingFan.parts)
+        renderQueue.submit(lightingShader, VAO, sceneGraph.world(node), fanMaterial);
+}
+
+void drawCube1(unsigned int& VAO, Shader& lightingShader, glm::mat4 model, glm::vec3 color)
+{
+    //color = glm::vec3(0.624f, 0.416f, 0.310f);
+    renderQueue.submit(lightingShader, VAO, model, solidMaterial(color));
+}
+
+
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    //make sure the viewport matches the new window dimensions; note that width and height will be significantly larger than specified on retina displays.
+    float aspectRatio = 4.0f / 3.0f;
+    int viewWidth, viewHeight;
+
+    if (width / (float)height > aspectRatio) {
+        //Window is too wide, fit height and adjust width
+        viewHeight = height;
+        viewWidth = (int)(height * aspectRatio);
+    }
+    else {
+        //Window is too tall, fit width and adjust height
+        viewWidth = width;
+        viewHeight = (int)(width / aspectRatio);
+    }
+
+    //Center the viewport
+    int xOffset = (width - viewWidth) / 2;
+    int yOffset = (height - viewHeight) / 2;
+
+    glViewport(xOffset, yOffset, viewWidth, viewHeight);
+    //glViewport(0, 0, width, height);
+}
+
+
+// Track whether the mouse button is pressed
+bool isMousePressed = false;
+
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    if (button == GLFW_MOUSE_BUTTON_LEFT) {
+        if (action == GLFW_PRESS) {
+            firstMouse = true;
+            isMousePressed = true;
+        }
+        else if (action == GLFW_RELEASE) {
+            isMousePressed = false;
+        }
+    }
+}
+
+void mouse_callback(GLFWwindow* window, double xposIn, double yposIn)
+{
+    float xpos = static_cast<float>(xposIn);
+    float ypos = static_cast<float>(yposIn);
+
+    if (firstMouse)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;       //reversed since y-coordinates go from bottom to top
+
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+
+// glfw: whenever the mouse scroll wheel scrolls, this callback is called
+// ----------------------------------------------------------------------
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(static_cast<float>(yoffset));
+}
+
+
+// If you are confused with it's usage, then pass an identity matrix to it, and everything will be fine 
+void drawCube(Shader& shaderProgram, unsigned int VAO, glm::mat4 parentTrans,
+    float posX, float posY, float posZ,
+    float rotX, float rotY, float rotZ,
+    float scX, float scY, float scZ,
+    float r, float g, float b) {
+
+    //while exporting, the arguments are the scene file's data
+    if (sceneExport) {
+        sceneExport->add(glm::vec3(posX, posY, posZ), glm::vec3(rotX, rotY, rotZ), glm::vec3(scX, scY, scZ), glm::vec3(r, g, b));
+        return;
+    }
+
+    //int colorLoc = glGetUniformLocation(shaderProgram.ID, "shapeColor");
+    //glUniform3f(colorLoc, 1.0f, 0.0f, 1.0f);
+    //glUniform3fv(colorLoc, 1, glm::value_ptr(glm::vec3(r, g, b)));
+
+    glm::vec3 color = glm::vec3(r, g, b);
+    //translate, rotate x, y, z, scale; the zero rotations of the kitchen are skipped, see batchtransform.h
+    glm::mat4 model = composeTransform(parentTrans, glm::vec3(posX, posY, posZ), glm::vec3(rotX, rotY, rotZ), glm::vec3(scX, scY, scZ));
+    //modelCentered = glm::translate(model, glm::vec3(-0.25, -0.25, -0.25));
+
+    emitCube(shaderProgram, VAO, model, color);
+}
+
+// a finished cube, from drawCube() or from the scene file
+void emitCube(Shader& lightingShader, unsigned int VAO, const glm::mat4& model, const glm::vec3& color, float shininess)
+{
+    //while a batch is recording the cube is only collected, the batch draws it later
+    if (staticBatch.recording) {
+        staticBatch.add(model, color);
+        return;
+    }
+
+    //queued, the render queue sets program, VAO and material only when they change
+    renderQueue.submit(lightingShader, VAO, model, solidMaterial(color, glm::vec3(0.0f), shininess));
+}
+
+
+
+void processInput(GLFWwindow* window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) on = true;
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) on = false;
+
+
+
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(FORWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(BACKWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(LEFT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(RIGHT, deltaTime);
+    }
+    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(UP, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(DOWN, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(P_UP, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(P_DOWN, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(Y_LEFT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(Y_RIGHT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(R_LEFT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS) {
+        if (!birdEye)
+            camera.ProcessKeyboard(R_RIGHT, deltaTime);
+    }
+    if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS)
+    {
+        eyeX += 2.5 * deltaTime;
+        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
+    }
+    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
+    {
+        eyeX -= 2.5 * deltaTime;
+        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
+    }
+  /*  if (glfwGetKey(window, GLFW_KEY_U) == GLFW_PRESS)
+    {
+        eyeZ += 2.5 * deltaTime;
+        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
+    }*/
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS)
+    {
+        eyeZ -= 2.5 * deltaTime;
+        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
+    }
+  /*  if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
+    {
+        eyeY += 2.5 * deltaTime;
+        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
+    }*/
+   /* if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS)
+    {
+        eyeY -= 2.5 * deltaTime;
+        basic_camera.eye = glm::vec3(eyeX, eyeY, eyeZ);
+    }*/
+
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS) {
+        birdEye = !birdEye;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_8) == GLFW_PRESS) frustumCulling = true;
+    if (glfwGetKey(window, GLFW_KEY_9) == GLFW_PRESS) frustumCulling = false;
+
+    if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
+        hizCulling = !hizCulling;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS) {
+        occlusionCulling = !occlusionCulling;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
+        clusteredLighting = !clusteredLighting;
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS) staticDrawMode = DRAW_PER_CUBE;
+    if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) staticDrawMode = DRAW_INSTANCED;
+    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) staticDrawMode = DRAW_BAKED;
+    if (glfwGetKey(window, GLFW_KEY_0) == GLFW_PRESS && gpuCuller.available()) staticDrawMode = DRAW_GPU_DRIVEN;
+
+    //F12 writes the trace recorded so far, once per press
+    static bool traceKeyDown = false;
+    bool traceKey = glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS;
+    if (traceKey && !traceKeyDown && frameTrace.recording)
+        frameTrace.write(tracePath);
+    traceKeyDown = traceKey;
+
+    if (birdEye) {
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
+            cameraPos.z -= birdEyeSpeed * deltaTime; // Move forward along Z
+            target.z -= birdEyeSpeed * deltaTime;
+            if (cameraPos.z <= 2.0) {
+                cameraPos.z = 2.0;
+            }
+            if (target.z <= -4.0) {
+                target.z = -4.0;
+            }
+        }
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+            cameraPos.z += birdEyeSpeed * deltaTime; // Move backward along Z
+            target.z += birdEyeSpeed * deltaTime;
+            if (cameraPos.z >= 13.5) {
+                cameraPos.z = 13.5;
+            }
+            if (target.z >= 7.5) {
+                target.z = 7.5;
+            }
+        }
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
+    {
+        if (!birdEye) {
+            theta += 0.01f;
+            camera.Position.x = lookAtX + radius * sin(theta);
+            camera.Position.y = lookAtY;
+            camera.Position.z = lookAtZ + radius * cos(theta);
+        }
+    }
+    if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) {
+        directionalLight.toggle();
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS) {
+        spotLight.toggle();
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) {
+        if (pointlight1.ambientOn > 0 && pointlight1.diffuseOn > 0 && pointlight1.specularOn > 0) {
+            pointlight1.turnOff();
+            point1 = false;
+        }
+        else {
+            pointlight1.turnOn();
+            point1 = true;
+        }
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) {
+        if (pointlight2.ambientOn > 0 && pointlight2.diffuseOn > 0 && pointlight2.specularOn > 0) {
+            pointlight2.turnOff();
+            point2 = false;
+        }
+        else {
+            pointlight2.turnOn();
+            point2 = true;
+        }
+    }
+
+    //5, 6 and 7 also switch the components of the directional light
+    if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS) {
+        if (directionalLight.on)
+            directionalLight.toggleAmbient();
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS) {
+        if (directionalLight.on)
+            directionalLight.toggleDiffuse();
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS) {
+        if (directionalLight.on)
+            directionalLight.toggleSpecular();
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS) {
+        if (pointlight1.ambientOn > 0 || pointlight2.ambientOn > 0) {
+            if (point1)
+                pointlight1.turnAmbientOff();
+            if (point2)
+                pointlight2.turnAmbientOff();
+        }
+        else {
+            if (point1)
+                pointlight1.turnAmbientOn();
+            if (point2)
+                pointlight2.turnAmbientOn();
+        }
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS) {
+        if (pointlight1.diffuseOn > 0 || pointlight2.diffuseOn > 0) {
+            if (point1)
+                pointlight1.turnDiffuseOff();
+            if (point2)
+                pointlight2.turnDiffuseOff();
+        }
+        else {
+            if (point1)
+                pointlight1.turnDiffuseOn();
+            if (point2)
+                pointlight2.turnDiffuseOn();
+        }
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_7) == GLFW_PRESS) {
+        if (pointlight1.specularOn > 0 || pointlight2.specularOn > 0) {
+            if (point1)
+                pointlight1.turnSpecularOff();
+            if (point2)
+                pointlight2.turnSpecularOff();
+        }
+        else {
+            if (point1)
+                pointlight1.turnSpecularOn();
+            if (point2)
+                pointlight2.turnSpecularOn();
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+//
+//  mappedfile.h
+//  Read-only memory mapping of a whole file
+//
+//  The file's pages are mapped straight into the address space, nothing is
+//  read or copied up front; the OS pages the data in on first touch.
+//  CreateFileMapping/MapViewOfFile on Windows, mmap everywhere else.
+//
+
+#ifndef mappedfile_h
+#define mappedfile_h
+
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+// glad defines APIENTRY too, windows.h brings back the same __stdcall
+#ifdef APIENTRY
+#undef APIENTRY
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    // false when the file is missing, empty or cannot be mapped
+    bool open(const char* path)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) {
+            close();
+            return false;
+        }
+        bytes = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (bytes == NULL) {
+            close();
+            return false;
+        }
+        length = (size_t)fileSize.QuadPart;
+#else
+        descriptor = ::open(path, O_RDONLY);
+        if (descriptor < 0)
+            return false;
+        struct stat info;
+        if (fstat(descriptor, &info) != 0 || info.st_size == 0) {
+            close();
+            return false;
+        }
+        void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (view == MAP_FAILED) {
+            close();
+            return false;
+        }
+        bytes = view;
+        length = (size_t)info.st_size;
+        // the loader walks every array front to back once
+        madvise(bytes, length, MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (bytes)
+            UnmapViewOfFile(bytes);
+        if (mapping != NULL)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes)
+            munmap(bytes, length);
+        if (descriptor >= 0)
+            ::close(descriptor);
+        descriptor = -1;
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const
+    {
+        return bytes != nullptr;
+    }
+
+    const unsigned char* data() const
+    {
+        return (const unsigned char*)bytes;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+private:
+    void* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int descriptor = -1;
+#endif
+};
+
+#endif /* mappedfile_h */
@@ -0,0 +1,55 @@
+#pragma once
+//
+//  normalmatrix.h
+//  Normal matrix computed once per object on the CPU
+//
+//  The Gouraud vertex shader used to run mat3(transpose(inverse(model)))
+//  for every vertex. The matrix is constant per draw, so it is computed
+//  here and passed as the normalMatrix uniform or as an instance attribute.
+//
+
+#ifndef normalmatrix_h
+#define normalmatrix_h
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+#include "shader.h"
+
+// a scale of 0 flattens a cube; this stands in for it so no normal becomes inf or NaN
+const float NORMAL_MATRIX_MIN_SCALE = 1e-6f;
+
+// inverse transpose of the upper 3x3 of model
+inline glm::mat3 computeNormalMatrix(const glm::mat4& model)
+{
+    // translate + axis-aligned scale (every drawCube() without rotation): the 3x3 part is diagonal,
+    // so its inverse transpose is just the reciprocal of the scale
+    if (model[0][1] == 0.0f && model[0][2] == 0.0f &&
+        model[1][0] == 0.0f && model[1][2] == 0.0f &&
+        model[2][0] == 0.0f && model[2][1] == 0.0f) {
+        glm::mat3 normalMatrix(0.0f);
+        for (int i = 0; i < 3; i++)
+            normalMatrix[i][i] = 1.0f / std::copysign(std::fmax(std::fabs(model[i][i]), NORMAL_MATRIX_MIN_SCALE), model[i][i]);
+        return normalMatrix;
+    }
+
+    // inverse transpose = cofactor matrix / determinant; a flattened object keeps the cofactors,
+    // which still point along the normals of its faces that have an area
+    glm::mat3 m(model);
+    glm::mat3 cofactor(glm::cross(m[1], m[2]), glm::cross(m[2], m[0]), glm::cross(m[0], m[1]));
+    float determinant = glm::dot(m[0], cofactor[0]);
+    float volume = glm::length(m[0]) * glm::length(m[1]) * glm::length(m[2]);
+    if (std::fabs(determinant) <= NORMAL_MATRIX_MIN_SCALE * volume)
+        return cofactor * (determinant < 0.0f ? -1.0f : 1.0f);
+    return cofactor * (1.0f / determinant);
+}
+
+// sets model and the matching normalMatrix on a lighting shader
+inline void setModelMatrix(Shader& lightingShader, const glm::mat4& model)
+{
+    lightingShader.setMat4("model", model);
+    lightingShader.setMat3("normalMatrix", computeNormalMatrix(model));
+}
+
+#endif /* normalmatrix_h */
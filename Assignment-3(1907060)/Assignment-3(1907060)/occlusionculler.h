@@ -0,0 +1,151 @@
+#pragma once
+//
+//  occlusionculler.h
+//  Hardware occlusion queries for the static cubes
+//
+//  After the scene is drawn, the AABB of every cube inside the frustum,
+//  slightly grown, is rendered as a proxy (no color or depth
+//  writes) inside a GL_ANY_SAMPLES_PASSED query. The results are read one
+//  frame later, only once the GPU reports them available, so the CPU never
+//  waits on a query.
+//  A cube whose proxy passed no samples is skipped until a later query
+//  sees it again. The results assume queries are issued every frame;
+//  after frames without them, invalidate() before the next filter().
+//
+
+#ifndef occlusionculler_h
+#define occlusionculler_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "shader.h"
+#include "frustumculler.h"
+
+class OcclusionCuller {
+public:
+    // counters of the last filter()
+    struct Stats {
+        unsigned int tested = 0;    // objects inside the frustum
+        unsigned int culled = 0;    // of those, skipped as hidden
+        unsigned int pending = 0;   // queries whose result was not back yet
+    } stats;
+
+    // one query per object of boxes, call again if the object count changes
+    void create(size_t count)
+    {
+        release();
+        queries.resize(count);
+        glGenQueries((GLsizei)count, queries.data());
+        pending.assign(count, 0);
+        occluded.assign(count, 0);
+        lastTested.assign(count, 0);
+        frame = 1;
+    }
+
+    // forgets every result and query in flight, they may be from a camera long gone
+    void invalidate()
+    {
+        // a query object can be begun again before its result is read, the old result is simply lost
+        std::fill(pending.begin(), pending.end(), 0);
+        std::fill(occluded.begin(), occluded.end(), 0);
+    }
+
+    // keeps the candidates (ascending indices) whose last available query saw them
+    void filter(const std::vector<unsigned int>& candidates, const FrustumCuller& boxes, const glm::vec3& cameraPos, float nearPlane, std::vector<unsigned int>& visible)
+    {
+        stats = Stats();
+        stats.tested = (unsigned int)candidates.size();
+        visible.clear();
+
+        for (unsigned int index : candidates) {
+            if (pending[index]) {
+                GLuint available = 0;
+                glGetQueryObjectuiv(queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available) {
+                    GLuint samplesPassed = 0;
+                    glGetQueryObjectuiv(queries[index], GL_QUERY_RESULT, &samplesPassed);
+                    occluded[index] = samplesPassed == 0;
+                    pending[index] = 0;
+                }
+                else {
+                    stats.pending++;
+                }
+            }
+
+            // a result from before the object left the frustum says nothing about now
+            bool stale = lastTested[index] + 1 < frame;
+            if (stale || !occluded[index] || cameraInside(boxes, index, cameraPos, nearPlane))
+                visible.push_back(index);
+        }
+        stats.culled = stats.tested - (unsigned int)visible.size();
+    }
+
+    // draws the proxy boxes of the candidates against the depth buffer of the frame
+    void issueQueries(const std::vector<unsigned int>& candidates, const FrustumCuller& boxes, Shader& proxyShader, unsigned int proxyVAO)
+    {
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        // the proxy goes through another program and transform than the cube, so its depths are not bit-identical
+        // to the cube's; inflating it and biasing it toward the camera keeps a cube from hiding its own proxy
+        glDepthFunc(GL_LEQUAL);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(-1.0f, -1.0f);
+
+        proxyShader.use();
+        glBindVertexArray(proxyVAO);
+        GLint modelLocation = proxyShader.uniformLocation("model");
+
+        for (unsigned int index : candidates) {
+            lastTested[index] = frame;
+            if (pending[index])
+                continue;
+
+            glm::vec3 extent = boxes.extent(index) + glm::vec3(PROXY_MARGIN);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), boxes.center(index) - extent);
+            model = glm::scale(model, 2.0f * extent);
+            proxyShader.setMat4(modelLocation, model);
+
+            glBeginQuery(GL_ANY_SAMPLES_PASSED, queries[index]);
+            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            glEndQuery(GL_ANY_SAMPLES_PASSED);
+            pending[index] = 1;
+        }
+
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        frame++;
+    }
+
+    void release()
+    {
+        if (!queries.empty())
+            glDeleteQueries((GLsizei)queries.size(), queries.data());
+        queries.clear();
+    }
+
+private:
+    static constexpr float PROXY_MARGIN = 0.005f;   // added on every side of a proxy box
+
+    std::vector<GLuint> queries;
+    std::vector<unsigned char> pending;
+    std::vector<unsigned char> occluded;
+    std::vector<unsigned int> lastTested;
+    unsigned int frame = 1;
+
+    // the proxy would be clipped by the near plane, so a box around the camera always counts as visible
+    static bool cameraInside(const FrustumCuller& boxes, unsigned int index, const glm::vec3& cameraPos, float nearPlane)
+    {
+        glm::vec3 distance = glm::abs(cameraPos - boxes.center(index));
+        glm::vec3 limit = boxes.extent(index) + glm::vec3(nearPlane);
+        return distance.x <= limit.x && distance.y <= limit.y && distance.z <= limit.z;
+    }
+};
+
+#endif /* occlusionculler_h */
@@ -0,0 +1,247 @@
+#pragma once
+//
+//  profiler.h
+//  Named CPU and GPU timing scopes, aggregated per frame
+//
+//  A ProfileScope measures the code between its construction and its
+//  destruction. The CPU side uses a steady clock. The GPU side puts a
+//  GL_TIMESTAMP query before and after the scope's commands; the queries
+//  of a frame live in one of FRAMES slots and are only read when their
+//  slot comes round again, FRAMES - 1 frames later, when the GPU is long
+//  done with them, so reading never stalls. Timestamp pairs, unlike
+//  GL_TIME_ELAPSED begin/end, can nest in each other and in a
+//  GL_TIME_ELAPSED query around the frame.
+//
+//  Time is summed per scope name within a frame and averaged over a
+//  report window (one second by default). The averages can be read with
+//  find() or printed at the end of every window. While the frame trace
+//  records, every scope is also a trace event, profiler enabled or not.
+//
+
+#ifndef profiler_h
+#define profiler_h
+
+#include <glad/glad.h>
+
+#include "frametrace.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class Profiler {
+public:
+    static const int FRAMES = 4;
+
+    struct ScopeStats {
+        std::string name;
+        double cpuMs = 0.0;         // per frame, averaged over the last report window
+        double gpuMs = 0.0;
+        double lastCpuMs = 0.0;     // of the last frame
+        double lastGpuMs = 0.0;     // of the last frame whose queries were read
+        bool gpuTimed = false;      // false for scopes measured on the CPU only
+
+        double frameCpuMs = 0.0;
+        double frameGpuMs = 0.0;
+        double windowCpuMs = 0.0;
+        double windowGpuMs = 0.0;
+    };
+
+    bool enabled = false;
+    bool printReports = false;      // print the averages at the end of every report window
+    double reportSeconds = 1.0;
+    unsigned int droppedFrames = 0; // frames whose GPU results were not ready when their slot came round
+
+    // index of the scope with this name, created on first use
+    int scope(const char* name)
+    {
+        for (size_t i = 0; i < stats.size(); i++)
+            if (stats[i].name == name)
+                return (int)i;
+        stats.emplace_back();
+        stats.back().name = name;
+        return (int)stats.size() - 1;
+    }
+
+    // the scope's stats, nullptr when it never ran
+    const ScopeStats* find(const char* name) const
+    {
+        for (const ScopeStats& s : stats)
+            if (s.name == name)
+                return &s;
+        return nullptr;
+    }
+
+    const std::vector<ScopeStats>& scopes() const
+    {
+        return stats;
+    }
+
+    // moves on to the next query slot, reading the GPU times it still holds from FRAMES frames ago
+    void beginFrame()
+    {
+        current = (current + 1) % FRAMES;
+        collect(slots[current]);
+    }
+
+    // closes the frame's CPU times; true when a report window ended with it
+    bool endFrame(double nowSeconds)
+    {
+        for (ScopeStats& s : stats) {
+            s.lastCpuMs = s.frameCpuMs;
+            s.windowCpuMs += s.frameCpuMs;
+            s.frameCpuMs = 0.0;
+        }
+        windowFrames++;
+
+        if (windowStart < 0.0)
+            windowStart = nowSeconds;
+        if (nowSeconds - windowStart < reportSeconds)
+            return false;
+
+        for (ScopeStats& s : stats) {
+            s.cpuMs = s.windowCpuMs / windowFrames;
+            s.gpuMs = windowGpuFrames > 0 ? s.windowGpuMs / windowGpuFrames : 0.0;
+            s.windowCpuMs = s.windowGpuMs = 0.0;
+        }
+        windowSeconds = nowSeconds - windowStart;
+        windowStart = nowSeconds;
+        windowFrames = windowGpuFrames = 0;
+        if (printReports)
+            print(std::cout);
+        return true;
+    }
+
+    void cpuEnd(int id, std::chrono::steady_clock::time_point start)
+    {
+        stats[id].frameCpuMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // returns the timestamp pair to pass to gpuEnd()
+    int gpuBegin(int id)
+    {
+        Slot& slot = slots[current];
+        if (slot.queries.size() < 2 * (slot.used + 1)) {
+            slot.queries.resize(2 * (slot.used + 1));
+            glGenQueries(2, &slot.queries[2 * slot.used]);
+            slot.pairScopes.resize(slot.used + 1);
+        }
+        stats[id].gpuTimed = true;
+        slot.pairScopes[slot.used] = id;
+        glQueryCounter(slot.queries[2 * slot.used], GL_TIMESTAMP);
+        return (int)slot.used++;
+    }
+
+    void gpuEnd(int pair)
+    {
+        glQueryCounter(slots[current].queries[2 * pair + 1], GL_TIMESTAMP);
+    }
+
+    void print(std::ostream& out) const
+    {
+        out << "profile, ms per frame over " << std::fixed << std::setprecision(2) << windowSeconds << " s" << std::endl;
+        out << "  " << std::left << std::setw(24) << "scope" << std::right << std::setw(10) << "cpu" << std::setw(10) << "gpu" << std::endl;
+        for (const ScopeStats& s : stats) {
+            out << "  " << std::left << std::setw(24) << s.name << std::right << std::setprecision(3) << std::setw(10) << s.cpuMs;
+            if (s.gpuTimed)
+                out << std::setw(10) << s.gpuMs;
+            out << std::endl;
+        }
+        out << std::defaultfloat;
+    }
+
+    void release()
+    {
+        for (Slot& slot : slots) {
+            if (!slot.queries.empty())
+                glDeleteQueries((GLsizei)slot.queries.size(), slot.queries.data());
+            slot.queries.clear();
+            slot.pairScopes.clear();
+            slot.used = 0;
+        }
+    }
+
+private:
+    struct Slot {
+        std::vector<unsigned int> queries;  // begin and end timestamp of every pair
+        std::vector<int> pairScopes;
+        size_t used = 0;                    // pairs issued in the frame that owns the slot
+    };
+
+    std::vector<ScopeStats> stats;
+    Slot slots[FRAMES];
+    int current = 0;
+    unsigned int windowFrames = 0;
+    unsigned int windowGpuFrames = 0;
+    double windowStart = -1.0;
+    double windowSeconds = 0.0;
+
+    void collect(Slot& slot)
+    {
+        if (slot.used == 0)
+            return;
+
+        // timestamps complete in order, the last one being ready means all are
+        GLint available = 0;
+        glGetQueryObjectiv(slot.queries[2 * slot.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            droppedFrames++;
+            slot.used = 0;
+            return;
+        }
+
+        for (size_t pair = 0; pair < slot.used; pair++) {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(slot.queries[2 * pair], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(slot.queries[2 * pair + 1], GL_QUERY_RESULT, &end);
+            stats[slot.pairScopes[pair]].frameGpuMs += (end - begin) / 1.0e6;
+        }
+        for (ScopeStats& s : stats) {
+            s.lastGpuMs = s.frameGpuMs;
+            s.windowGpuMs += s.frameGpuMs;
+            s.frameGpuMs = 0.0;
+        }
+        windowGpuFrames++;
+        slot.used = 0;
+    }
+};
+
+// the one profiler of the program, enabled in main() with --profile
+inline Profiler profiler;
+
+// times its own lifetime under name, on the GPU too unless gpu is false; name must be a string literal
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name, bool gpu = true)
+        : trace(name)
+    {
+        if (!profiler.enabled)
+            return;
+        id = profiler.scope(name);
+        if (gpu)
+            pair = profiler.gpuBegin(id);
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~ProfileScope()
+    {
+        if (id < 0)
+            return;
+        profiler.cpuEnd(id, start);
+        if (pair >= 0)
+            profiler.gpuEnd(pair);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    TraceScope trace;
+    int id = -1;
+    int pair = -1;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif /* profiler_h */
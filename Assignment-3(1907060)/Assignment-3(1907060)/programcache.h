@@ -0,0 +1,190 @@
+#pragma once
+//
+//  programcache.h
+//  Linked shader programs kept on disk as driver binaries
+//
+//  After a program is linked for the first time, glGetProgramBinary saves
+//  it into the cache directory; later runs load it with glProgramBinary
+//  and skip compiling and linking. A binary is named by a 64-bit FNV-1a
+//  hash of the driver's vendor, renderer and version strings and of the
+//  final sources, #defines included, so any change to a shader file, a
+//  permutation or the driver gives a new name. Drivers may still reject a
+//  binary (after an update that kept the version string, say); the file
+//  is then deleted and the program is compiled as usual.
+//
+//  Without GL 4.1 or ARB_get_program_binary the cache does nothing.
+//
+
+#ifndef programcache_h
+#define programcache_h
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "glextensions.h"
+
+class ProgramCache {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    std::string directory = "shadercache";
+    bool enabled = true;
+
+    // since the start: binaries loaded, programs compiled and saved, binaries the driver refused
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    unsigned int rejected = 0;
+
+    bool active() const
+    {
+        return enabled && glext.programBinarySupported();
+    }
+
+    // name of the program built from these sources on this driver
+    uint64_t key(const std::vector<const std::string*>& sources)
+    {
+        if (!active())
+            return 0;
+        if (driver.empty()) {
+            const char* strings[3] = { (const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION) };
+            for (const char* s : strings) {
+                driver += s ? s : "";
+                driver += '\0';
+            }
+        }
+
+        uint64_t hash = 14695981039346656037ull;
+        hash = fnv1a(hash, &VERSION, sizeof(VERSION));
+        hash = fnv1a(hash, driver.data(), driver.size());
+        for (const std::string* source : sources) {
+            // the terminator keeps "ab" + "c" apart from "a" + "bc"
+            hash = fnv1a(hash, source->c_str(), source->size() + 1);
+        }
+        return hash;
+    }
+
+    // links program from its cached binary; false when there is none or the driver refused it
+    bool load(uint64_t programKey, GLuint program)
+    {
+        if (!active())
+            return false;
+
+        std::ifstream in(pathFor(programKey), std::ios::binary);
+        if (!in)
+            return false;
+        BinaryHeader header;
+        std::vector<char> binary;
+        if (in.read((char*)&header, sizeof(header)) && header.magic == MAGIC && header.version == VERSION && header.key == programKey && header.length <= MAX_BINARY_BYTES) {
+            binary.resize(header.length);
+            in.read(binary.data(), header.length);
+        }
+        bool complete = in && !binary.empty();
+        in.close();
+
+        GLint linked = GL_FALSE;
+        if (complete) {
+            glext.programBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        }
+        if (!linked) {
+            rejected++;
+            std::error_code ignored;
+            std::filesystem::remove(pathFor(programKey), ignored);
+            return false;
+        }
+        hits++;
+        return true;
+    }
+
+    // call before glLinkProgram, so the driver keeps the binary around
+    void prepare(GLuint program) const
+    {
+        if (active())
+            glext.programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // saves a freshly linked program
+    void store(uint64_t programKey, GLuint program)
+    {
+        if (!active())
+            return;
+        misses++;
+
+        GLint linked = GL_FALSE, length = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (!linked || length <= 0)
+            return;
+
+        BinaryHeader header;
+        std::vector<char> binary(length);
+        GLsizei written = 0;
+        glext.getProgramBinary(program, length, &written, &header.format, binary.data());
+        if (written <= 0)
+            return;
+        header.key = programKey;
+        header.length = (uint32_t)written;
+
+        // written to a temporary name and renamed, another instance never reads half a file
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        std::string path = pathFor(programKey);
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write((const char*)&header, sizeof(header));
+            out.write(binary.data(), written);
+            if (!out) {
+                std::cout << "ERROR::PROGRAM_CACHE::FILE_NOT_SUCCESSFULLY_WRITTEN: " << temporary << std::endl;
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+            std::filesystem::remove(temporary, error);
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x4752504B;              // "KPRG" little endian
+    static constexpr uint32_t MAX_BINARY_BYTES = 64u << 20;    // a larger length means a damaged file
+
+    struct BinaryHeader {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t key = 0;
+        GLenum format = 0;
+        uint32_t length = 0;
+    };
+
+    std::string driver;
+
+    std::string pathFor(uint64_t programKey) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)programKey);
+        return directory + "/" + name;
+    }
+
+    static uint64_t fnv1a(uint64_t hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+// the one program cache of the program, every Shader goes through it
+inline ProgramCache programCache;
+
+#endif /* programcache_h */
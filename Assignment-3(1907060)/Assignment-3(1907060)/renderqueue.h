@@ -0,0 +1,357 @@
+#pragma once
+//
+//  renderqueue.h
+//  Sorted submission of individual draws
+//
+//  Draws are submitted as small commands instead of being issued right away.
+//  Each command carries a 64-bit sort key
+//      [63:56] layer   [55:48] program   [47:40] VAO   [39:24] material   [23:0] depth
+//  so after a radix sort all draws of one program are together, then of one
+//  VAO, then of one material, and within that they go front to back.
+//  flush() then only calls use(), glBindVertexArray and the material setters
+//  when the value actually changes. With culling on, draws whose cube lies
+//  outside the view frustum are dropped before the sort.
+//  With a RingBuffer attached, the model matrix and material of every draw
+//  are written once into the frame's ring region and each draw only binds
+//  its range of the Object uniform block instead of setting uniforms.
+//  A draw whose program, VAO or material no longer fits its key field is
+//  refused rather than given an id that aliases other state.
+//
+
+#ifndef renderqueue_h
+#define renderqueue_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "shader.h"
+#include "normalmatrix.h"
+#include "frustumculler.h"
+#include "uniformbuffers.h"
+#include "ringbuffer.h"
+
+struct Material {
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+    glm::vec3 emissive;
+    float shininess;
+
+    bool operator==(const Material& other) const
+    {
+        return ambient == other.ambient && diffuse == other.diffuse && specular == other.specular &&
+            emissive == other.emissive && shininess == other.shininess;
+    }
+};
+
+// the single-color material every cube of the scene uses
+inline Material solidMaterial(const glm::vec3& color, const glm::vec3& emissive = glm::vec3(0.0f), float shininess = 32.0f)
+{
+    Material material;
+    material.ambient = color;
+    material.diffuse = color;
+    material.specular = color;
+    material.emissive = emissive;
+    material.shininess = shininess;
+    return material;
+}
+
+// draws that must come after everything else, whatever their state
+enum RenderLayer {
+    LAYER_OPAQUE = 0,
+    LAYER_LAST = 255
+};
+
+class RenderQueue {
+public:
+    // state changes issued by the last flush(), for comparing against unsorted drawing
+    struct Stats {
+        unsigned int draws = 0;
+        unsigned int programChanges = 0;
+        unsigned int vaoChanges = 0;
+        unsigned int materialChanges = 0;
+        unsigned int culled = 0;
+    } stats;
+
+    // drop submitted cubes outside the frustum given to begin()
+    bool culling = true;
+
+    // per-draw data goes through this ring when set, through uniforms otherwise
+    RingBuffer* ring = nullptr;
+
+    // starts a frame, view and far plane are used for the depth part of the key
+    void begin(const glm::mat4& view, const glm::mat4& projection, float farPlane)
+    {
+        this->view = view;
+        frustum = extractFrustum(projection * view);
+        depthScale = (float)DEPTH_MAX / farPlane;
+        commands.clear();
+        items.clear();
+        culler.clear();
+    }
+
+    // false, and nothing drawn, when the program, VAO or material table is full
+    bool submit(Shader& shader, unsigned int VAO, const glm::mat4& model, const Material& material,
+        GLsizei indexCount = 36, RenderLayer layer = LAYER_OPAQUE)
+    {
+        int program = programId(shader), vao = vaoId(VAO), materialIndex = materialId(material);
+        if (program < 0 || vao < 0 || materialIndex < 0)
+            return false;
+
+        DrawItem item;
+        item.shader = &shader;
+        item.VAO = VAO;
+        item.indexCount = indexCount;
+        item.material = materialIndex;
+        item.model = model;
+
+        // view depth of the model origin, good enough to order whole cubes
+        float depth = -(view[0][2] * model[3][0] + view[1][2] * model[3][1] + view[2][2] * model[3][2] + view[3][2]);
+        float scaled = depth * depthScale;
+        uint64_t depthBits = scaled <= 0.0f ? 0 : scaled >= (float)DEPTH_MAX ? DEPTH_MAX : (uint64_t)scaled;
+
+        uint64_t key = ((uint64_t)layer << 56)
+            | ((uint64_t)program << 48)
+            | ((uint64_t)vao << 40)
+            | ((uint64_t)item.material << 24)
+            | depthBits;
+
+        commands.push_back({ key, (uint32_t)items.size() });
+        items.push_back(item);
+        culler.addCube(model);  // every mesh drawn through the queue is the unit cube
+        return true;
+    }
+
+    // sorts the frame's commands and issues them
+    void flush()
+    {
+        stats = Stats();
+        if (culling) {
+            // commands are still in submission order, so command i is box i
+            culler.cull(frustum);
+            stats.culled = (unsigned int)(commands.size() - culler.visible.size());
+            for (size_t i = 0; i < culler.visible.size(); i++)
+                commands[i] = commands[culler.visible[i]];
+            commands.resize(culler.visible.size());
+        }
+
+        sortCommands();
+
+        // one allocation for the whole frame, written in draw order
+        RingAllocation objects;
+        GLsizeiptr stride = 0;
+        bool throughRing = false;
+        if (ring && !commands.empty()) {
+            stride = ((GLsizeiptr)sizeof(ObjectBlock) + ring->alignment - 1) / ring->alignment * ring->alignment;
+            throughRing = ring->allocate(stride * (GLsizeiptr)commands.size(), objects);
+        }
+        if (throughRing) {
+            for (size_t i = 0; i < commands.size(); i++)
+                writeObject((char*)objects.data + i * stride, items[commands[i].item]);
+            ring->commit(objects);
+        }
+
+        const Shader* currentShader = nullptr;
+        bool currentLit = false;
+        unsigned int currentVAO = 0;
+        bool vaoBound = false;
+        int currentMaterial = -1;
+
+        for (size_t i = 0; i < commands.size(); i++) {
+            const Command& command = commands[i];
+            const DrawItem& item = items[command.item];
+
+            if (item.shader != currentShader) {
+                if (currentShader && throughRing)
+                    currentShader->setBool("dynamicObject", false);
+                item.shader->use();
+                if (throughRing)
+                    item.shader->setBool("dynamicObject", true);
+                currentShader = item.shader;
+                currentLit = programs[(command.key >> 48) & 0xff].lit;
+                currentMaterial = -1;   // uniforms belong to the program
+                stats.programChanges++;
+            }
+            if (!vaoBound || item.VAO != currentVAO) {
+                glBindVertexArray(item.VAO);
+                currentVAO = item.VAO;
+                vaoBound = true;
+                stats.vaoChanges++;
+            }
+
+            if (throughRing) {
+                glBindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BLOCK_BINDING, ring->ID, objects.offset + (GLintptr)i * stride, sizeof(ObjectBlock));
+            }
+            else {
+                if (item.material != currentMaterial) {
+                    applyMaterial(*item.shader, currentLit, materials[item.material]);
+                    currentMaterial = item.material;
+                    stats.materialChanges++;
+                }
+
+                if (currentLit)
+                    setModelMatrix(*item.shader, item.model);
+                else
+                    item.shader->setMat4("model", item.model);
+            }
+
+            glDrawElements(GL_TRIANGLES, item.indexCount, GL_UNSIGNED_INT, 0);
+            stats.draws++;
+        }
+
+        // the static draws of the next frame use the plain uniforms again
+        if (currentShader && throughRing)
+            currentShader->setBool("dynamicObject", false);
+
+        commands.clear();
+        items.clear();
+        culler.clear();
+    }
+
+private:
+    static const uint64_t DEPTH_MAX = (1u << 24) - 1;
+    static const size_t MAX_PROGRAMS = 256;     // sizes of the key fields
+    static const size_t MAX_VAOS = 256;
+    static const size_t MAX_MATERIALS = 65536;
+
+    struct Command {
+        uint64_t key;
+        uint32_t item;
+    };
+
+    struct DrawItem {
+        Shader* shader;
+        unsigned int VAO;
+        GLsizei indexCount;
+        int material;
+        glm::mat4 model;
+    };
+
+    struct ProgramEntry {
+        const Shader* shader;
+        bool lit;       // has the material/normalMatrix uniforms of the lighting shader
+    };
+
+    glm::mat4 view = glm::mat4(1.0f);
+    Frustum frustum;
+    FrustumCuller culler;
+    float depthScale = 1.0f;
+
+    std::vector<Command> commands;
+    std::vector<Command> sortBuffer;
+    std::vector<DrawItem> items;
+
+    // small registries so the key only needs a few bits for each kind of state
+    std::vector<ProgramEntry> programs;
+    std::vector<unsigned int> vaos;
+    std::vector<Material> materials;
+
+    // the ids below are -1 once a table is full
+    int programId(const Shader& shader)
+    {
+        for (size_t i = 0; i < programs.size(); i++)
+            if (programs[i].shader == &shader)
+                return (int)i;
+        assert(programs.size() < MAX_PROGRAMS && "more programs than the sort key holds");
+        if (programs.size() >= MAX_PROGRAMS)
+            return -1;
+        programs.push_back({ &shader, shader.uniformLocation("normalMatrix") >= 0 });
+        return (int)(programs.size() - 1);
+    }
+
+    int vaoId(unsigned int VAO)
+    {
+        for (size_t i = 0; i < vaos.size(); i++)
+            if (vaos[i] == VAO)
+                return (int)i;
+        assert(vaos.size() < MAX_VAOS && "more VAOs than the sort key holds");
+        if (vaos.size() >= MAX_VAOS)
+            return -1;
+        vaos.push_back(VAO);
+        return (int)(vaos.size() - 1);
+    }
+
+    // the scene only has a few dozen colors, a linear search is enough
+    int materialId(const Material& material)
+    {
+        for (size_t i = materials.size(); i-- > 0; )
+            if (materials[i] == material)
+                return (int)i;
+        assert(materials.size() < MAX_MATERIALS && "more materials than the sort key holds");
+        if (materials.size() >= MAX_MATERIALS)
+            return -1;
+        materials.push_back(material);
+        return (int)(materials.size() - 1);
+    }
+
+    // the Object block of one draw, written field by field straight into the mapped ring
+    void writeObject(void* destination, const DrawItem& item) const
+    {
+        const Material& material = materials[item.material];
+        glm::mat3 normalMatrix = computeNormalMatrix(item.model);
+
+        ObjectBlock* object = (ObjectBlock*)destination;
+        object->model = item.model;
+        for (int c = 0; c < 3; c++)
+            object->normalMatrix[c] = glm::vec4(normalMatrix[c], 0.0f);
+        object->color = glm::vec4(material.diffuse, 1.0f);
+        object->ambient = material.ambient;
+        object->diffuse = material.diffuse;
+        object->specular = material.specular;
+        object->emissive = material.emissive;
+        object->shininess = material.shininess;
+    }
+
+    static void applyMaterial(const Shader& shader, bool lit, const Material& material)
+    {
+        if (lit) {
+            shader.setVec3("material.ambient", material.ambient);
+            shader.setVec3("material.diffuse", material.diffuse);
+            shader.setVec3("material.specular", material.specular);
+            shader.setVec3("material.emissive", material.emissive);
+            shader.setFloat("material.shininess", material.shininess);
+        }
+        else {
+            shader.setVec4("color", glm::vec4(material.diffuse, 1.0f));
+        }
+    }
+
+    // LSD radix sort on the key, one byte per pass; passes where every key has the same byte are skipped
+    void sortCommands()
+    {
+        size_t count = commands.size();
+        if (count < 2)
+            return;
+        sortBuffer.resize(count);
+
+        Command* source = commands.data();
+        Command* destination = sortBuffer.data();
+        for (int shift = 0; shift < 64; shift += 8) {
+            size_t histogram[256] = {};
+            for (size_t i = 0; i < count; i++)
+                histogram[(source[i].key >> shift) & 0xff]++;
+            if (histogram[(source[0].key >> shift) & 0xff] == count)
+                continue;
+
+            size_t offset = 0;
+            for (size_t& bucket : histogram) {
+                size_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+            for (size_t i = 0; i < count; i++)
+                destination[histogram[(source[i].key >> shift) & 0xff]++] = source[i];
+            std::swap(source, destination);
+        }
+
+        if (source != commands.data())
+            commands.swap(sortBuffer);
+    }
+};
+
+#endif /* renderqueue_h */
@@ -0,0 +1,173 @@
+#pragma once
+//
+//  ringbuffer.h
+//  Triple-buffered ring for data that is rewritten every frame
+//
+//  One buffer holds FRAMES regions. Each frame writes into its own region
+//  while the GPU may still read the previous two; a fence placed at the end
+//  of the frame protects a region until the GPU is done with it.
+//
+//  On GL 4.4 the buffer is created with glBufferStorage and mapped once,
+//  persistent and coherent, so allocate() hands out pointers straight into
+//  GPU-visible memory. On older contexts every allocation maps its range
+//  with GL_MAP_UNSYNCHRONIZED_BIT instead; the fences make that safe too.
+//
+
+#ifndef ringbuffer_h
+#define ringbuffer_h
+
+#include <glad/glad.h>
+
+#include "glextensions.h"
+
+struct RingAllocation {
+    void* data = nullptr;
+    GLintptr offset = 0;    // from the start of RingBuffer::ID, for glBindBufferRange
+    GLsizeiptr size = 0;
+};
+
+class RingBuffer {
+public:
+    static const int FRAMES = 3;
+
+    unsigned int ID = 0;
+    GLsizeiptr frameSize = 0;
+    GLint alignment = 256;      // offsets handed out are multiples of this
+    bool persistent = false;    // mapped once for the whole run
+
+    // alignment should cover GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT when ranges are bound as uniform blocks
+    void create(GLsizeiptr bytesPerFrame, GLint offsetAlignment)
+    {
+        alignment = offsetAlignment > 0 ? offsetAlignment : 1;
+        frameSize = alignUp(bytesPerFrame);
+        persistent = glext.persistentMappingSupported();
+
+        glGenBuffers(1, &ID);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+        if (persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glext.bufferStorage(GL_COPY_WRITE_BUFFER, frameSize * FRAMES, NULL, flags);
+            mapped = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, frameSize * FRAMES, flags);
+            if (mapped == nullptr) {
+                // keep going through the unsynchronized path
+                persistent = false;
+                glDeleteBuffers(1, &ID);
+                glGenBuffers(1, &ID);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+            }
+        }
+        if (!persistent)
+            glBufferData(GL_COPY_WRITE_BUFFER, frameSize * FRAMES, NULL, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        frame = 0;
+        used = 0;
+        wanted = 0;
+    }
+
+    // waits until the GPU has finished reading this frame's region; grows the ring if the last frame ran out
+    void beginFrame()
+    {
+        if (wanted > frameSize) {
+            GLsizeiptr bytesPerFrame = wanted * 2;
+            releaseBuffer();
+            create(bytesPerFrame, alignment);
+        }
+
+        waitFence(fences[frame]);
+        used = 0;
+        wanted = 0;
+    }
+
+    // space for size bytes in this frame's region; false when it is full, the ring then grows next frame
+    bool allocate(GLsizeiptr size, RingAllocation& allocation)
+    {
+        GLsizeiptr start = used;
+        GLsizeiptr end = alignUp(start + size);
+        if (end > frameSize) {
+            wanted = (wanted > frameSize ? wanted : frameSize) + alignUp(size);
+            return false;
+        }
+        used = end;
+
+        allocation.offset = frame * frameSize + start;
+        allocation.size = size;
+        if (persistent) {
+            allocation.data = mapped + allocation.offset;
+        }
+        else {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+            allocation.data = glMapBufferRange(GL_COPY_WRITE_BUFFER, allocation.offset, size,
+                GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+            if (allocation.data == nullptr) {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the allocation is written, make it visible to GL; required before drawing with it
+    void commit(const RingAllocation& allocation)
+    {
+        if (persistent)
+            return;     // coherent mapping, nothing to flush
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    // fences the region of this frame after its last draw and moves on to the next one
+    void endFrame()
+    {
+        if (fences[frame])
+            glDeleteSync(fences[frame]);
+        fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        frame = (frame + 1) % FRAMES;
+    }
+
+    void release()
+    {
+        releaseBuffer();
+        frameSize = 0;
+    }
+
+private:
+    char* mapped = nullptr;
+    GLsync fences[FRAMES] = {};
+    int frame = 0;
+    GLsizeiptr used = 0;
+    GLsizeiptr wanted = 0;
+
+    GLsizeiptr alignUp(GLsizeiptr size) const
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    static void waitFence(GLsync& fence)
+    {
+        if (!fence)
+            return;
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        while (result == GL_TIMEOUT_EXPIRED)
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);   // 1 ms
+        glDeleteSync(fence);
+        fence = 0;
+    }
+
+    void releaseBuffer()
+    {
+        for (GLsync& fence : fences)
+            waitFence(fence);
+        if (persistent && ID) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &ID);
+        ID = 0;
+        mapped = nullptr;
+    }
+};
+
+#endif /* ringbuffer_h */
@@ -0,0 +1,281 @@
+#pragma once
+//
+//  scenefile.h
+//  Binary scene format for the static cubes
+//
+//  A scene file is a fixed header followed by arrays, each starting on a
+//  16 byte boundary: position, rotation (degrees) and scale of every cube
+//  as separate vec3 arrays, a material index per cube and a material
+//  table. The arrays are used in place from a memory mapped file, so
+//  loading does no parsing at all: the header is checked and the cubes are
+//  handed out straight from the mapped pages. Floats and integers are
+//  stored little-endian, as every target of this project uses them.
+//
+//  SceneWriter produces the files; main.cpp --export-scene records the
+//  built-in kitchen into one.
+//
+
+#ifndef scenefile_h
+#define scenefile_h
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "mappedfile.h"
+#include "batchtransform.h"
+#include "jobsystem.h"
+
+const char SCENE_FILE_MAGIC[4] = { 'K', 'S', 'C', 'N' };
+const uint32_t SCENE_FILE_VERSION = 1;
+
+// offsets are in bytes from the start of the file
+struct SceneFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t objectCount;
+    uint32_t materialCount;
+    uint64_t positionsOffset;       // glm::vec3[objectCount]
+    uint64_t rotationsOffset;       // glm::vec3[objectCount], degrees around x, then y, then z
+    uint64_t scalesOffset;          // glm::vec3[objectCount]
+    uint64_t materialIndicesOffset; // uint32_t[objectCount]
+    uint64_t materialsOffset;       // SceneMaterial[materialCount]
+};
+
+struct SceneMaterial {
+    glm::vec3 color;
+    float shininess;
+};
+
+// the arrays of a scene, mapped from a file or still in a SceneWriter
+struct SceneArrays {
+    size_t count = 0;
+    const glm::vec3* positions = nullptr;
+    const glm::vec3* rotations = nullptr;
+    const glm::vec3* scales = nullptr;
+    const uint32_t* materialIndices = nullptr;
+    const SceneMaterial* materials = nullptr;
+};
+
+// models[p * count + i] is cube i under parents[p]; the matrices are composed a chunk at a time on the job threads
+inline void composeSceneCubes(const SceneArrays& cubes, const glm::mat4* parents, size_t parentCount, std::vector<glm::mat4>& models)
+{
+    const size_t CHUNK = 1024;
+    models.resize(cubes.count * parentCount);
+    if (cubes.count == 0)
+        return;
+    // a chunk never crosses a parent, each one composes with a single parent matrix
+    size_t chunksPerParent = (cubes.count + CHUNK - 1) / CHUNK;
+    jobs.parallelFor(0, chunksPerParent * parentCount, 1, [&](size_t firstChunk, size_t endChunk) {
+        for (size_t chunk = firstChunk; chunk < endChunk; chunk++) {
+            size_t parent = chunk / chunksPerParent;
+            size_t first = chunk % chunksPerParent * CHUNK;
+            size_t count = std::min(CHUNK, cubes.count - first);
+            composeTransforms(parents[parent], cubes.positions + first, cubes.rotations + first, cubes.scales + first, count,
+                models.data() + parent * cubes.count + first);
+        }
+    });
+}
+
+static_assert(sizeof(SceneFileHeader) == 56, "SceneFileHeader layout changed, bump SCENE_FILE_VERSION");
+static_assert(sizeof(glm::vec3) == 12, "scene arrays expect tightly packed vec3");
+static_assert(sizeof(SceneMaterial) == 16, "SceneMaterial layout changed, bump SCENE_FILE_VERSION");
+
+class SceneFile {
+public:
+    // maps the file and checks its header, the arrays are not touched until they are used
+    bool open(const char* path)
+    {
+        close();
+        if (!file.open(path)) {
+            std::cout << "ERROR::SCENE::FILE_NOT_SUCCESSFULLY_OPENED: " << path << std::endl;
+            return false;
+        }
+        if (!validate()) {
+            std::cout << "ERROR::SCENE::INVALID_FILE: " << path << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        file.close();
+        header = nullptr;
+    }
+
+    bool isOpen() const
+    {
+        return header != nullptr;
+    }
+
+    size_t size() const
+    {
+        return header ? header->objectCount : 0;
+    }
+
+    const glm::vec3* positions() const { return array<glm::vec3>(header->positionsOffset); }
+    const glm::vec3* rotations() const { return array<glm::vec3>(header->rotationsOffset); }
+    const glm::vec3* scales() const { return array<glm::vec3>(header->scalesOffset); }
+    const uint32_t* materialIndices() const { return array<uint32_t>(header->materialIndicesOffset); }
+    const SceneMaterial* materials() const { return array<SceneMaterial>(header->materialsOffset); }
+
+    SceneArrays arrays() const
+    {
+        SceneArrays cubes;
+        if (isOpen())
+            cubes = { size(), positions(), rotations(), scales(), materialIndices(), materials() };
+        return cubes;
+    }
+
+    // calls emit(model, material) for every cube, in file order, on the calling thread
+    template <typename Emit>
+    void forEachCube(const glm::mat4& parent, Emit emit) const
+    {
+        if (!isOpen())
+            return;
+        // matrices are composed straight from the mapped arrays, in parallel
+        std::vector<glm::mat4> models;
+        SceneArrays cubes = arrays();
+        composeSceneCubes(cubes, &parent, 1, models);
+        for (size_t i = 0; i < cubes.count; i++)
+            emit(models[i], cubes.materials[cubes.materialIndices[i]]);
+    }
+
+private:
+    MappedFile file;
+    const SceneFileHeader* header = nullptr;
+
+    template <typename T>
+    const T* array(uint64_t offset) const
+    {
+        return (const T*)(file.data() + offset);
+    }
+
+    bool validate()
+    {
+        if (file.size() < sizeof(SceneFileHeader))
+            return false;
+        const SceneFileHeader* candidate = (const SceneFileHeader*)file.data();
+        if (memcmp(candidate->magic, SCENE_FILE_MAGIC, 4) != 0 || candidate->version != SCENE_FILE_VERSION)
+            return false;
+
+        uint64_t objects = candidate->objectCount;
+        if (!fits(candidate->positionsOffset, objects * sizeof(glm::vec3)) ||
+            !fits(candidate->rotationsOffset, objects * sizeof(glm::vec3)) ||
+            !fits(candidate->scalesOffset, objects * sizeof(glm::vec3)) ||
+            !fits(candidate->materialIndicesOffset, objects * sizeof(uint32_t)) ||
+            !fits(candidate->materialsOffset, candidate->materialCount * (uint64_t)sizeof(SceneMaterial)))
+            return false;
+
+        // one pass over the indices, every later access is then in range
+        const uint32_t* indices = (const uint32_t*)(file.data() + candidate->materialIndicesOffset);
+        for (uint64_t i = 0; i < objects; i++)
+            if (indices[i] >= candidate->materialCount)
+                return false;
+
+        header = candidate;
+        return true;
+    }
+
+    // array starts aligned and ends inside the file
+    bool fits(uint64_t offset, uint64_t bytes) const
+    {
+        return offset % 16 == 0 && offset >= sizeof(SceneFileHeader) &&
+            offset <= file.size() && bytes <= file.size() - offset;
+    }
+};
+
+class SceneWriter {
+public:
+    // one cube with the arguments of drawCube()
+    void add(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, const glm::vec3& color, float shininess = 32.0f)
+    {
+        positions.push_back(position);
+        rotations.push_back(rotation);
+        scales.push_back(scale);
+        materialIndices.push_back(materialIndex(color, shininess));
+    }
+
+    size_t size() const
+    {
+        return positions.size();
+    }
+
+    // valid until the next add()
+    SceneArrays arrays() const
+    {
+        return { positions.size(), positions.data(), rotations.data(), scales.data(), materialIndices.data(), materials.data() };
+    }
+
+    bool write(const char* path) const
+    {
+        SceneFileHeader header = {};
+        memcpy(header.magic, SCENE_FILE_MAGIC, 4);
+        header.version = SCENE_FILE_VERSION;
+        header.objectCount = (uint32_t)positions.size();
+        header.materialCount = (uint32_t)materials.size();
+
+        uint64_t offset = sizeof(SceneFileHeader);
+        header.positionsOffset = place(offset, positions.size() * sizeof(glm::vec3));
+        header.rotationsOffset = place(offset, rotations.size() * sizeof(glm::vec3));
+        header.scalesOffset = place(offset, scales.size() * sizeof(glm::vec3));
+        header.materialIndicesOffset = place(offset, materialIndices.size() * sizeof(uint32_t));
+        header.materialsOffset = place(offset, materials.size() * sizeof(SceneMaterial));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cout << "ERROR::SCENE::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+            return false;
+        }
+        out.write((const char*)&header, sizeof(header));
+        writeArray(out, header.positionsOffset, positions.data(), positions.size() * sizeof(glm::vec3));
+        writeArray(out, header.rotationsOffset, rotations.data(), rotations.size() * sizeof(glm::vec3));
+        writeArray(out, header.scalesOffset, scales.data(), scales.size() * sizeof(glm::vec3));
+        writeArray(out, header.materialIndicesOffset, materialIndices.data(), materialIndices.size() * sizeof(uint32_t));
+        writeArray(out, header.materialsOffset, materials.data(), materials.size() * sizeof(SceneMaterial));
+        return (bool)out;
+    }
+
+private:
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<uint32_t> materialIndices;
+    std::vector<SceneMaterial> materials;
+
+    // the kitchen uses a dozen colors, a linear search is plenty
+    uint32_t materialIndex(const glm::vec3& color, float shininess)
+    {
+        for (size_t i = 0; i < materials.size(); i++)
+            if (materials[i].color == color && materials[i].shininess == shininess)
+                return (uint32_t)i;
+        materials.push_back({ color, shininess });
+        return (uint32_t)(materials.size() - 1);
+    }
+
+    // aligned start of the next array, offset moves past it
+    static uint64_t place(uint64_t& offset, uint64_t bytes)
+    {
+        uint64_t start = (offset + 15) / 16 * 16;
+        offset = start + bytes;
+        return start;
+    }
+
+    static void writeArray(std::ofstream& out, uint64_t offset, const void* data, uint64_t bytes)
+    {
+        static const char padding[16] = {};
+        uint64_t position = (uint64_t)out.tellp();
+        out.write(padding, (std::streamsize)(offset - position));
+        if (bytes)
+            out.write((const char*)data, (std::streamsize)bytes);
+    }
+};
+
+#endif /* scenefile_h */
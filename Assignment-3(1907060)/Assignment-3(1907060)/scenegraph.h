@@ -0,0 +1,117 @@
+#pragma once
+//
+//  scenegraph.h
+//  Transform hierarchy with cached world matrices
+//
+//  Nodes live in flat arrays in depth-first order: a node comes after its
+//  parent and its whole subtree follows it contiguously, up to
+//  subtreeEnd. Changing a local matrix only marks the node dirty; update()
+//  then recomputes exactly the dirty subtrees with one forward walk each,
+//  where every parent's world matrix is already final. Nodes outside a
+//  dirty subtree are never touched.
+//
+
+#ifndef scenegraph_h
+#define scenegraph_h
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+class SceneGraph {
+public:
+    static const int NO_PARENT = -1;
+
+    // world matrices recomputed by the last update()
+    unsigned int lastUpdated = 0;
+
+    // appends a node; parent must be NO_PARENT or a node whose subtree is still the tail of the array
+    int addNode(int parent, const glm::mat4& local)
+    {
+        int node = (int)locals.size();
+        assert(parent == NO_PARENT || subtreeEnds[parent] == node);
+
+        parents.push_back(parent);
+        locals.push_back(local);
+        worlds.push_back(parent == NO_PARENT ? local : worlds[parent] * local);
+        subtreeEnds.push_back(node + 1);
+        dirty.push_back(0);
+
+        for (int ancestor = parent; ancestor != NO_PARENT; ancestor = parents[ancestor])
+            subtreeEnds[ancestor] = node + 1;
+        return node;
+    }
+
+    void setLocal(int node, const glm::mat4& local)
+    {
+        locals[node] = local;
+        if (!dirty[node]) {
+            dirty[node] = 1;
+            dirtyNodes.push_back(node);
+        }
+    }
+
+    const glm::mat4& local(int node) const
+    {
+        return locals[node];
+    }
+
+    const glm::mat4& world(int node) const
+    {
+        return worlds[node];
+    }
+
+    int parent(int node) const
+    {
+        return parents[node];
+    }
+
+    // one past the last node of the subtree of node
+    int subtreeEnd(int node) const
+    {
+        return subtreeEnds[node];
+    }
+
+    int size() const
+    {
+        return (int)locals.size();
+    }
+
+    // brings the world matrix of every dirty node and its descendants up to date
+    void update()
+    {
+        lastUpdated = 0;
+        if (dirtyNodes.empty())
+            return;
+
+        // in array order a dirty node inside an already refreshed subtree is skipped
+        std::sort(dirtyNodes.begin(), dirtyNodes.end());
+        int refreshedUpTo = 0;
+        for (int node : dirtyNodes) {
+            dirty[node] = 0;
+            if (node < refreshedUpTo)
+                continue;
+
+            int end = subtreeEnds[node];
+            for (int i = node; i < end; i++) {
+                int p = parents[i];
+                worlds[i] = p == NO_PARENT ? locals[i] : worlds[p] * locals[i];
+            }
+            lastUpdated += end - node;
+            refreshedUpTo = end;
+        }
+        dirtyNodes.clear();
+    }
+
+private:
+    std::vector<int> parents;
+    std::vector<glm::mat4> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<int> subtreeEnds;
+    std::vector<unsigned char> dirty;
+    std::vector<int> dirtyNodes;
+};
+
+#endif /* scenegraph_h */
@@ -1,174 +1,473 @@
-#pragma once
-//
-//  shader.h
-//  3D Object Drawing
-//
-//  Created by Nazirul Hasan on 4/9/23.
-//
-
-#ifndef SHADER_H
-#define SHADER_H
-
-#include <glad/glad.h>
-#include <glm/glm.hpp>
-
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <iostream>
-
-class Shader
-{
-public:
-    unsigned int ID;
-    // constructor generates the shader on the fly
-    // ------------------------------------------------------------------------
-    Shader(const char* vertexPath, const char* fragmentPath)
-    {
-        // 1. retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        try
-        {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
-        }
-        catch (std::ifstream::failure& e)
-        {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
-        }
-        const char* vShaderCode = vertexCode.c_str();
-        const char* fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
-        unsigned int vertex, fragment;
-        // vertex shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-        // fragment Shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-        // shader Program
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-        // delete the shaders as they're linked into our program now and no longer necessary
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-
-    }
-    // activate the shader
-    // ------------------------------------------------------------------------
-    void use() const
-    {
-        glUseProgram(ID);
-    }
-    // utility uniform functions
-    // ------------------------------------------------------------------------
-    void setBool(const std::string& name, bool value) const
-    {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
-    }
-    // ------------------------------------------------------------------------
-    void setInt(const std::string& name, int value) const
-    {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
-    }
-    // ------------------------------------------------------------------------
-    void setFloat(const std::string& name, float value) const
-    {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
-    }
-    // ------------------------------------------------------------------------
-    void setVec2(const std::string& name, const glm::vec2& value) const
-    {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-    }
-    void setVec2(const std::string& name, float x, float y) const
-    {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
-    }
-    // ------------------------------------------------------------------------
-    void setVec3(const std::string& name, const glm::vec3& value) const
-    {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-    }
-    void setVec3(const std::string& name, float x, float y, float z) const
-    {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
-    }
-    // ------------------------------------------------------------------------
-    void setVec4(const std::string& name, const glm::vec4& value) const
-    {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-    }
-    void setVec4(const std::string& name, float x, float y, float z, float w) const
-    {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
-    }
-    // ------------------------------------------------------------------------
-    void setMat2(const std::string& name, const glm::mat2& mat) const
-    {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-    }
-    // ------------------------------------------------------------------------
-    void setMat3(const std::string& name, const glm::mat3& mat) const
-    {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-    }
-    // ------------------------------------------------------------------------
-    void setMat4(const std::string& name, const glm::mat4& mat) const
-    {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-    }
-
-private:
-    // utility function for checking shader compilation/linking errors.
-    // ------------------------------------------------------------------------
-    void checkCompileErrors(GLuint shader, std::string type)
-    {
-        GLint success;
-        GLchar infoLog[1024];
-        if (type != "PROGRAM")
-        {
-            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-            if (!success)
-            {
-                glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-            }
-        }
-        else
-        {
-            glGetProgramiv(shader, GL_LINK_STATUS, &success);
-            if (!success)
-            {
-                glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
-            }
-        }
-    }
-};
-#endif
+#pragma once
+//
+//  shader.h
+//  3D Object Drawing
+//
+//  Created by Nazirul Hasan on 4/9/23.
+//
+
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include "glextensions.h"
+#include "programcache.h"
+#include "shadercompileworker.h"
+
+// COMPILE_NOW links in the constructor; COMPILE_DEFERRED only starts compiling and linking,
+// on the driver's threads (KHR_parallel_shader_compile) or on shaderCompileWorker, and the
+// program is finished the first time it is used or ready() finds it done
+enum ShaderCompileMode {
+    COMPILE_NOW,
+    COMPILE_DEFERRED
+};
+
+class Shader
+{
+public:
+    unsigned int ID;
+    // constructor generates the shader on the fly, defines ("NAME" or "NAME VALUE") are injected after #version
+    // ------------------------------------------------------------------------
+    Shader(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& defines = {}, ShaderCompileMode mode = COMPILE_NOW)
+    {
+        // 1. retrieve the vertex/fragment source code from filePath
+        std::string vertexCode;
+        std::string fragmentCode;
+        std::ifstream vShaderFile;
+        std::ifstream fShaderFile;
+        // ensure ifstream objects can throw exceptions:
+        vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        try
+        {
+            // open files
+            vShaderFile.open(vertexPath);
+            fShaderFile.open(fragmentPath);
+            std::stringstream vShaderStream, fShaderStream;
+            // read file's buffer contents into streams
+            vShaderStream << vShaderFile.rdbuf();
+            fShaderStream << fShaderFile.rdbuf();
+            // close file handlers
+            vShaderFile.close();
+            fShaderFile.close();
+            // convert stream into string
+            vertexCode = vShaderStream.str();
+            fragmentCode = fShaderStream.str();
+        }
+        catch (std::ifstream::failure& e)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+        }
+        vertexCode = injectDefines(vertexCode, defines);
+        fragmentCode = injectDefines(fragmentCode, defines);
+        // 2. a binary of the same sources saved by an earlier run replaces compiling and linking
+        ID = glCreateProgram();
+        uint64_t binaryKey = programCache.key({ &vertexCode, &fragmentCode });
+        if (programCache.load(binaryKey, ID))
+        {
+            // look up every active uniform once, the setters never query GL again
+            cacheUniformLocations();
+            return;
+        }
+        // 3. compile shaders, the shader objects are named here so both contexts see the same names
+        pending = std::make_shared<PendingProgram>();
+        pending->binaryKey = binaryKey;
+        pending->stages.push_back({ GL_VERTEX_SHADER, std::move(vertexCode), "VERTEX", glCreateShader(GL_VERTEX_SHADER) });
+        pending->stages.push_back({ GL_FRAGMENT_SHADER, std::move(fragmentCode), "FRAGMENT", glCreateShader(GL_FRAGMENT_SHADER) });
+        if (mode == COMPILE_DEFERRED && !glext.parallelShaderCompileSupported() && shaderCompileWorker.running())
+        {
+            // the worker's context shares objects with ours; glFinish makes its results visible here
+            pending->onWorker = true;
+            std::shared_ptr<PendingProgram> job = pending;
+            GLuint program = ID;
+            shaderCompileWorker.submit([job, program]() {
+                compileAndLink(*job, program);
+                glFinish();
+                job->compiled.store(true, std::memory_order_release);
+            });
+        }
+        else
+        {
+            // with KHR_parallel_shader_compile these calls return at once and the driver works in the background
+            pending->parallel = mode == COMPILE_DEFERRED && glext.parallelShaderCompileSupported();
+            compileAndLink(*pending, ID);
+        }
+        if (mode == COMPILE_NOW)
+            finishCompile();
+    }
+    // compute program from a single file, needs a 4.3 context
+    // ------------------------------------------------------------------------
+    explicit Shader(const char* computePath, const std::vector<std::string>& defines = {})
+    {
+        std::string computeCode;
+        std::ifstream cShaderFile;
+        cShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        try
+        {
+            cShaderFile.open(computePath);
+            std::stringstream cShaderStream;
+            cShaderStream << cShaderFile.rdbuf();
+            cShaderFile.close();
+            computeCode = cShaderStream.str();
+        }
+        catch (std::ifstream::failure& e)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+        }
+        computeCode = injectDefines(computeCode, defines);
+        const char* cShaderCode = computeCode.c_str();
+
+        ID = glCreateProgram();
+        uint64_t binaryKey = programCache.key({ &computeCode });
+        if (!programCache.load(binaryKey, ID))
+        {
+            unsigned int compute = glCreateShader(GL_COMPUTE_SHADER);
+            glShaderSource(compute, 1, &cShaderCode, NULL);
+            glCompileShader(compute);
+            checkCompileErrors(compute, "COMPUTE");
+
+            glAttachShader(ID, compute);
+            programCache.prepare(ID);
+            glLinkProgram(ID);
+            checkCompileErrors(ID, "PROGRAM");
+            glDeleteShader(compute);
+            programCache.store(binaryKey, ID);
+        }
+        cacheUniformLocations();
+    }
+    // true once the program is linked and usable without waiting; never blocks
+    // ------------------------------------------------------------------------
+    bool ready() const
+    {
+        if (!pending)
+            return true;
+        if (pending->onWorker && !pending->compiled.load(std::memory_order_acquire))
+            return false;
+        if (pending->parallel)
+        {
+            GLint done = GL_FALSE;
+            glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+            if (!done)
+                return false;
+        }
+        finishCompile();
+        return true;
+    }
+    // block until a deferred program is linked, called by everything that needs the program
+    // ------------------------------------------------------------------------
+    void wait() const
+    {
+        if (!pending)
+            return;
+        // the link status query blocks by itself when the driver compiles in parallel
+        while (pending->onWorker && !pending->compiled.load(std::memory_order_acquire))
+            std::this_thread::yield();
+        finishCompile();
+    }
+    // activate the shader
+    // ------------------------------------------------------------------------
+    void use() const
+    {
+        wait();
+        glUseProgram(ID);
+    }
+    // attach a uniform block of the program to a shared binding point, ignored if the program does not declare it
+    // ------------------------------------------------------------------------
+    void bindUniformBlock(const char* blockName, GLuint binding) const
+    {
+        // a program still compiling gets its bindings when it is finished
+        if (pending)
+        {
+            pending->blockBindings.push_back({ blockName, binding });
+            return;
+        }
+        GLuint index = glGetUniformBlockIndex(ID, blockName);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, binding);
+    }
+    // location of a uniform from the table built after linking, -1 (ignored by glUniform*) if it is not active
+    // ------------------------------------------------------------------------
+    GLint uniformLocation(std::string_view name) const
+    {
+        wait();
+        auto it = std::lower_bound(uniforms.begin(), uniforms.end(), name,
+            [](const UniformEntry& entry, std::string_view key) { return std::string_view(entry.name) < key; });
+        if (it != uniforms.end() && it->name == name)
+            return it->location;
+        return -1;
+    }
+    // utility uniform functions, by name
+    // ------------------------------------------------------------------------
+    void setBool(std::string_view name, bool value) const
+    {
+        setBool(uniformLocation(name), value);
+    }
+    // ------------------------------------------------------------------------
+    void setInt(std::string_view name, int value) const
+    {
+        setInt(uniformLocation(name), value);
+    }
+    // ------------------------------------------------------------------------
+    void setFloat(std::string_view name, float value) const
+    {
+        setFloat(uniformLocation(name), value);
+    }
+    // ------------------------------------------------------------------------
+    void setVec2(std::string_view name, const glm::vec2& value) const
+    {
+        setVec2(uniformLocation(name), value);
+    }
+    void setVec2(std::string_view name, float x, float y) const
+    {
+        setVec2(uniformLocation(name), x, y);
+    }
+    // ------------------------------------------------------------------------
+    void setVec3(std::string_view name, const glm::vec3& value) const
+    {
+        setVec3(uniformLocation(name), value);
+    }
+    void setVec3(std::string_view name, float x, float y, float z) const
+    {
+        setVec3(uniformLocation(name), x, y, z);
+    }
+    // ------------------------------------------------------------------------
+    void setVec4(std::string_view name, const glm::vec4& value) const
+    {
+        setVec4(uniformLocation(name), value);
+    }
+    void setVec4(std::string_view name, float x, float y, float z, float w) const
+    {
+        setVec4(uniformLocation(name), x, y, z, w);
+    }
+    // ------------------------------------------------------------------------
+    void setMat2(std::string_view name, const glm::mat2& mat) const
+    {
+        setMat2(uniformLocation(name), mat);
+    }
+    // ------------------------------------------------------------------------
+    void setMat3(std::string_view name, const glm::mat3& mat) const
+    {
+        setMat3(uniformLocation(name), mat);
+    }
+    // ------------------------------------------------------------------------
+    void setMat4(std::string_view name, const glm::mat4& mat) const
+    {
+        setMat4(uniformLocation(name), mat);
+    }
+    // utility uniform functions, by location from uniformLocation()
+    // ------------------------------------------------------------------------
+    void setBool(GLint location, bool value) const
+    {
+        glUniform1i(location, (int)value);
+    }
+    // ------------------------------------------------------------------------
+    void setInt(GLint location, int value) const
+    {
+        glUniform1i(location, value);
+    }
+    // ------------------------------------------------------------------------
+    void setFloat(GLint location, float value) const
+    {
+        glUniform1f(location, value);
+    }
+    // ------------------------------------------------------------------------
+    void setVec2(GLint location, const glm::vec2& value) const
+    {
+        glUniform2fv(location, 1, &value[0]);
+    }
+    void setVec2(GLint location, float x, float y) const
+    {
+        glUniform2f(location, x, y);
+    }
+    // ------------------------------------------------------------------------
+    void setVec3(GLint location, const glm::vec3& value) const
+    {
+        glUniform3fv(location, 1, &value[0]);
+    }
+    void setVec3(GLint location, float x, float y, float z) const
+    {
+        glUniform3f(location, x, y, z);
+    }
+    // ------------------------------------------------------------------------
+    void setVec4(GLint location, const glm::vec4& value) const
+    {
+        glUniform4fv(location, 1, &value[0]);
+    }
+    void setVec4(GLint location, float x, float y, float z, float w) const
+    {
+        glUniform4f(location, x, y, z, w);
+    }
+    // ------------------------------------------------------------------------
+    void setMat2(GLint location, const glm::mat2& mat) const
+    {
+        glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
+    // ------------------------------------------------------------------------
+    void setMat3(GLint location, const glm::mat3& mat) const
+    {
+        glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
+    // ------------------------------------------------------------------------
+    void setMat4(GLint location, const glm::mat4& mat) const
+    {
+        glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
+
+private:
+    struct UniformEntry {
+        std::string name;
+        GLint location;
+    };
+    // active uniforms of the linked program, sorted by name
+    mutable std::vector<UniformEntry> uniforms;
+
+    struct PendingStage {
+        GLenum type;
+        std::string source;
+        const char* label;
+        GLuint shader;
+    };
+    // a program whose compile and link were started but not yet checked, shared with the worker's job
+    struct PendingProgram {
+        std::vector<PendingStage> stages;
+        uint64_t binaryKey = 0;
+        bool parallel = false;      // the driver compiles it, poll GL_COMPLETION_STATUS_KHR
+        bool onWorker = false;      // shaderCompileWorker compiles it, poll compiled
+        std::atomic<bool> compiled{ false };
+        std::vector<std::pair<std::string, GLuint>> blockBindings;
+    };
+    // null once the program is finished
+    mutable std::shared_ptr<PendingProgram> pending;
+
+    // compile every stage and link, without reading back any status (that would wait for the compiler)
+    // ------------------------------------------------------------------------
+    static void compileAndLink(const PendingProgram& program, GLuint id)
+    {
+        for (const PendingStage& stage : program.stages)
+        {
+            const char* code = stage.source.c_str();
+            glShaderSource(stage.shader, 1, &code, NULL);
+            glCompileShader(stage.shader);
+            glAttachShader(id, stage.shader);
+        }
+        programCache.prepare(id);
+        glLinkProgram(id);
+    }
+
+    // report errors, save the binary and build the uniform table of a program compileAndLink() finished
+    // ------------------------------------------------------------------------
+    void finishCompile() const
+    {
+        std::shared_ptr<PendingProgram> program = std::move(pending);
+        for (const PendingStage& stage : program->stages)
+            checkCompileErrors(stage.shader, stage.label);
+        checkCompileErrors(ID, "PROGRAM");
+        // delete the shaders as they're linked into our program now and no longer necessary
+        for (const PendingStage& stage : program->stages)
+            glDeleteShader(stage.shader);
+        programCache.store(program->binaryKey, ID);
+        // look up every active uniform once, the setters never query GL again
+        cacheUniformLocations();
+        for (const auto& binding : program->blockBindings)
+            bindUniformBlock(binding.first.c_str(), binding.second);
+    }
+
+    // insert a #define line per entry right after the #version line of the source
+    // ------------------------------------------------------------------------
+    static std::string injectDefines(const std::string& code, const std::vector<std::string>& defines)
+    {
+        if (defines.empty())
+            return code;
+
+        std::string block;
+        for (const std::string& define : defines)
+            block += "#define " + define + "\n";
+
+        size_t version = code.find("#version");
+        size_t lineEnd = version == std::string::npos ? std::string::npos : code.find('\n', version);
+        if (lineEnd == std::string::npos)
+            return block + code;
+
+        // #line keeps compiler error line numbers pointing at the file
+        return code.substr(0, lineEnd + 1) + block + "#line 2\n" + code.substr(lineEnd + 1);
+    }
+
+    // enumerate the active uniforms of the program into the location table
+    // ------------------------------------------------------------------------
+    void cacheUniformLocations() const
+    {
+        uniforms.clear();
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<GLchar> nameBuffer(maxLength > 0 ? maxLength : 1);
+
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+            std::string name(nameBuffer.data(), length);
+            GLint location = glGetUniformLocation(ID, name.c_str());
+            if (location < 0)
+                continue;   // uniform block members have no location
+
+            uniforms.push_back({ name, location });
+
+            // arrays are reported as "name[0]", also accept "name" and every "name[i]"
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+                std::string base = name.substr(0, name.size() - 3);
+                uniforms.push_back({ base, location });
+                for (GLint element = 1; element < size; element++) {
+                    std::string elementName = base + "[" + std::to_string(element) + "]";
+                    uniforms.push_back({ elementName, glGetUniformLocation(ID, elementName.c_str()) });
+                }
+            }
+        }
+
+        std::sort(uniforms.begin(), uniforms.end(),
+            [](const UniformEntry& a, const UniformEntry& b) { return a.name < b.name; });
+    }
+
+    // utility function for checking shader compilation/linking errors.
+    // ------------------------------------------------------------------------
+    void checkCompileErrors(GLuint shader, std::string type) const
+    {
+        GLint success;
+        GLchar infoLog[1024];
+        if (type != "PROGRAM")
+        {
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success)
+            {
+                glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+                std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        }
+        else
+        {
+            glGetProgramiv(shader, GL_LINK_STATUS, &success);
+            if (!success)
+            {
+                glGetProgramInfoLog(shader, 1024, NULL, infoLog);
+                std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+            }
+        }
+    }
+};
+#endif
 #pragma once
\ No newline at end of file
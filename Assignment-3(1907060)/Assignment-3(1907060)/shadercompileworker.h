@@ -0,0 +1,97 @@
+#pragma once
+//
+//  shadercompileworker.h
+//  Background thread that compiles and links shader programs
+//
+//  Used when the driver has no GL_KHR_parallel_shader_compile. The thread
+//  owns a second context that shares objects with the window's, so the
+//  program and shader names created on the main thread are the same on
+//  both. Jobs run in submission order; the main thread only checks a flag
+//  the job sets when it is done and never waits unless it has to draw
+//  with the program.
+//
+//  Nothing here knows about the window system: start() gets a function
+//  that makes the shared context current on the calling thread (true) or
+//  releases it (false).
+//
+
+#ifndef shadercompileworker_h
+#define shadercompileworker_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class ShaderCompileWorker {
+public:
+    ~ShaderCompileWorker()
+    {
+        stop();
+    }
+
+    void start(std::function<void(bool current)> bindContext)
+    {
+        stop();
+        stopping = false;
+        worker = std::thread(&ShaderCompileWorker::run, this, std::move(bindContext));
+    }
+
+    // runs the queued jobs before the thread ends, so no program stays unfinished and wait() always returns
+    void stop()
+    {
+        if (!worker.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    bool running() const
+    {
+        return worker.joinable();
+    }
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+private:
+    std::thread worker;
+    std::mutex queueLock;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+
+    void run(std::function<void(bool current)> bindContext)
+    {
+        bindContext(true);
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(queueLock);
+                wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty())
+                    break;      // stopping with nothing left
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+        bindContext(false);
+    }
+};
+
+// the one compile worker of the program, started in main() when the driver cannot compile in parallel itself
+inline ShaderCompileWorker shaderCompileWorker;
+
+#endif /* shadercompileworker_h */
@@ -0,0 +1,152 @@
+#pragma once
+//
+//  shaderpermutations.h
+//  Specialized program variants keyed by a light feature mask
+//
+//  Each variant is compiled with the light switches and the point light
+//  count as #defines, so disabled lights are removed at compile time
+//  instead of branching per vertex. Variants are compiled the first time
+//  their mask is requested and kept for the rest of the run.
+//
+//  With COMPILE_DEFERRED, prepare() starts compiling variants ahead of
+//  time and get() never waits for one: until the asked-for variant is
+//  linked it returns the fallback, the same shaders with only the point
+//  light count defined. The fallback reads the light switches from the
+//  Lights block at run time, so it draws the same picture, only slower.
+//
+
+#ifndef shaderpermutations_h
+#define shaderpermutations_h
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "shader.h"
+#include "uniformbuffers.h"
+
+enum ShaderFeature {
+    FEATURE_DIRECTIONAL_LIGHT = 1 << 0,
+    FEATURE_DIRECTIONAL_AMBIENT = 1 << 1,
+    FEATURE_DIRECTIONAL_DIFFUSE = 1 << 2,
+    FEATURE_DIRECTIONAL_SPECULAR = 1 << 3,
+    FEATURE_SPOT_LIGHT = 1 << 4,
+    FEATURE_CLUSTERED_LIGHTS = 1 << 5
+};
+
+class ShaderPermutations {
+public:
+    ShaderCompileMode mode = COMPILE_NOW;
+
+    ShaderPermutations(const char* vertexPath, const char* fragmentPath)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath)
+    {
+    }
+
+    // the variant for a feature mask and point light count, compiled on first use;
+    // with COMPILE_DEFERRED the fallback while that variant is still compiling
+    Shader& get(unsigned int features, int pointLightCount)
+    {
+        Shader& shader = prepare(features, pointLightCount);
+        if (mode == COMPILE_NOW || shader.ready())
+            return shader;
+        return prepareFallback(features & FEATURE_CLUSTERED_LIGHTS, pointLightCount);
+    }
+
+    // starts compiling a variant without waiting for it
+    Shader& prepare(unsigned int features, int pointLightCount)
+    {
+        features = normalize(features);
+        if (pointLightCount > MAX_POINT_LIGHTS)
+            pointLightCount = MAX_POINT_LIGHTS;
+        return variant(features | ((unsigned int)pointLightCount << 16), definesFor(features, pointLightCount));
+    }
+
+    // every light switch combination, clustered or not, for one point light count
+    void prepareAll(bool clustered, int pointLightCount)
+    {
+        unsigned int extra = clustered ? FEATURE_CLUSTERED_LIGHTS : 0;
+        for (unsigned int features = 0; features < FEATURE_CLUSTERED_LIGHTS; features++) {
+            if (normalize(features) == features)
+                prepare(features | extra, pointLightCount);
+        }
+    }
+
+    // the program get() hands out while a variant compiles; prepare it before the variants so it is linked first
+    Shader& prepareFallback(bool clustered, int pointLightCount)
+    {
+        if (pointLightCount > MAX_POINT_LIGHTS)
+            pointLightCount = MAX_POINT_LIGHTS;
+        unsigned int features = clustered ? FEATURE_CLUSTERED_LIGHTS : 0;
+        std::vector<std::string> defines = {
+            "MAX_POINT_LIGHTS " + std::to_string(MAX_POINT_LIGHTS),
+            "NR_POINT_LIGHTS " + std::to_string(pointLightCount)
+        };
+        if (clustered)
+            defines.push_back("CLUSTERED_LIGHTS");
+        return variant(FALLBACK_KEY | features | ((unsigned int)pointLightCount << 16), defines);
+    }
+
+    // every variant, e.g. to release them
+    std::map<unsigned int, Shader>& all()
+    {
+        return variants;
+    }
+
+    void release()
+    {
+        for (auto& variant : variants)
+            glDeleteProgram(variant.second.ID);
+        variants.clear();
+    }
+
+private:
+    // above every feature bit, below the point light count
+    static const unsigned int FALLBACK_KEY = 1u << 15;
+
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::map<unsigned int, Shader> variants;
+
+    Shader& variant(unsigned int key, const std::vector<std::string>& defines)
+    {
+        auto it = variants.find(key);
+        if (it != variants.end())
+            return it->second;
+
+        Shader& shader = variants.emplace(key, Shader(vertexPath.c_str(), fragmentPath.c_str(), defines, mode)).first->second;
+        bindSharedUniformBlocks(shader);
+        return shader;
+    }
+
+    // the directional components do not matter while the directional light is off
+    static unsigned int normalize(unsigned int features)
+    {
+        if (!(features & FEATURE_DIRECTIONAL_LIGHT))
+            features &= ~(unsigned int)(FEATURE_DIRECTIONAL_AMBIENT | FEATURE_DIRECTIONAL_DIFFUSE | FEATURE_DIRECTIONAL_SPECULAR);
+        return features;
+    }
+
+    static const char* flag(unsigned int features, ShaderFeature feature)
+    {
+        return (features & feature) ? "true" : "false";
+    }
+
+    static std::vector<std::string> definesFor(unsigned int features, int pointLightCount)
+    {
+        std::vector<std::string> defines = {
+            "MAX_POINT_LIGHTS " + std::to_string(MAX_POINT_LIGHTS),
+            "NR_POINT_LIGHTS " + std::to_string(pointLightCount),
+            std::string("DIRECTIONAL_LIGHT ") + flag(features, FEATURE_DIRECTIONAL_LIGHT),
+            std::string("DIRECTIONAL_AMBIENT ") + flag(features, FEATURE_DIRECTIONAL_AMBIENT),
+            std::string("DIRECTIONAL_DIFFUSE ") + flag(features, FEATURE_DIRECTIONAL_DIFFUSE),
+            std::string("DIRECTIONAL_SPECULAR ") + flag(features, FEATURE_DIRECTIONAL_SPECULAR),
+            std::string("SPOT_LIGHT ") + flag(features, FEATURE_SPOT_LIGHT)
+        };
+        if (features & FEATURE_CLUSTERED_LIGHTS)
+            defines.push_back("CLUSTERED_LIGHTS");
+        return defines;
+    }
+};
+
+#endif /* shaderpermutations_h */
@@ -0,0 +1,81 @@
+#pragma once
+#ifndef spotLight_h
+#define spotLight_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "uniformbuffers.h"
+
+class SpotLight {
+public:
+    glm::vec3 position;
+    glm::vec3 direction;
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+    float k_c;
+    float k_l;
+    float k_q;
+    float cos_theta;
+
+    SpotLight(float posX, float posY, float posZ, float dirX, float dirY, float dirZ, float ambR, float ambG, float ambB, float diffR, float diffG, float diffB, float specR, float specG, float specB, float constant, float linear, float quadratic, float cutOffDegrees) {
+        position = glm::vec3(posX, posY, posZ);
+        direction = glm::vec3(dirX, dirY, dirZ);
+        ambient = glm::vec3(ambR, ambG, ambB);
+        diffuse = glm::vec3(diffR, diffG, diffB);
+        specular = glm::vec3(specR, specG, specB);
+        k_c = constant;
+        k_l = linear;
+        k_q = quadratic;
+        cos_theta = glm::cos(glm::radians(cutOffDegrees));
+    }
+
+    // writes this light and its switch into the Lights uniform block
+    void setUpSpotLight(LightsBlock& lights)
+    {
+        SpotLightData& light = lights.spotLight;
+        light.position = position;
+        light.direction = direction;
+        light.ambient = ambient;
+        light.diffuse = diffuse;
+        light.specular = specular;
+        light.k_c = k_c;
+        light.k_l = k_l;
+        light.k_q = k_q;
+        light.cos_theta = cos_theta;
+        lights.spotLightOn = on;
+        dirty = false;
+    }
+
+    // call after changing any of the public light parameters directly
+    void markDirty() {
+        dirty = true;
+    }
+
+    void turnOn() {
+        setSwitch(true);
+    }
+
+    void turnOff() {
+        setSwitch(false);
+    }
+
+    void toggle() {
+        setSwitch(!on);
+    }
+
+    bool on = true;
+
+    // set whenever the light changes, cleared once it has been written to the uniform block
+    bool dirty = true;
+
+private:
+    void setSwitch(bool value) {
+        if (on != value) {
+            on = value;
+            dirty = true;
+        }
+    }
+};
+
+#endif /* spotLight_h */
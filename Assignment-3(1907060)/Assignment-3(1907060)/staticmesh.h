@@ -0,0 +1,163 @@
+#pragma once
+//
+//  staticmesh.h
+//  Static scene baked into a single vertex buffer
+//
+//  Every recorded cube is transformed to world space once at startup and
+//  merged into one VBO/EBO, so the static room is a single glDrawElements
+//  with no per-object uniforms. The indices of each cube stay contiguous, so
+//  a culled subset is drawn with one glMultiDrawElements over the runs of
+//  consecutive visible cubes.
+//
+
+#ifndef staticmesh_h
+#define staticmesh_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "shader.h"
+#include "cubebatch.h"
+
+// world-space position, normal and material color, read at locations 0, 1 and 6
+struct BakedVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec3 color;
+};
+
+class StaticMesh {
+public:
+    unsigned int VAO = 0;
+    unsigned int VBO = 0;
+    unsigned int EBO = 0;
+    unsigned int indexCount = 0;
+    unsigned int cubeIndexCount = 0;
+
+    // cubeVertices holds position + normal per vertex (6 floats), cubeIndices the triangles of one cube
+    void bake(const std::vector<CubeInstance>& instances, const float* cubeVertices, unsigned int cubeVertexCount, const unsigned int* cubeIndices, unsigned int cubeIndexCount)
+    {
+        std::vector<BakedVertex> vertices;
+        std::vector<unsigned int> indices;
+        vertices.reserve(instances.size() * cubeVertexCount);
+        indices.reserve(instances.size() * cubeIndexCount);
+
+        for (const CubeInstance& instance : instances) {
+            unsigned int base = (unsigned int)vertices.size();
+            const glm::mat3& normalMatrix = instance.normalMatrix;
+
+            for (unsigned int v = 0; v < cubeVertexCount; v++) {
+                const float* src = cubeVertices + v * 6;
+                BakedVertex vertex;
+                vertex.position = glm::vec3(instance.model * glm::vec4(src[0], src[1], src[2], 1.0f));
+                // a face flattened to no area has a zero normal, normalizing it would give NaN
+                glm::vec3 normal = normalMatrix * glm::vec3(src[3], src[4], src[5]);
+                vertex.normal = glm::dot(normal, normal) > 0.0f ? glm::normalize(normal) : normal;
+                vertex.color = instance.color;
+                vertices.push_back(vertex);
+            }
+            for (unsigned int i = 0; i < cubeIndexCount; i++)
+                indices.push_back(base + cubeIndices[i]);
+        }
+        indexCount = (unsigned int)indices.size();
+        this->cubeIndexCount = cubeIndexCount;
+
+        if (VAO == 0) {
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+            glGenBuffers(1, &EBO);
+        }
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(BakedVertex), vertices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+        // position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(BakedVertex), (void*)offsetof(BakedVertex, position));
+        glEnableVertexAttribArray(0);
+
+        // normal attribute
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(BakedVertex), (void*)offsetof(BakedVertex, normal));
+        glEnableVertexAttribArray(1);
+
+        // material color
+        glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(BakedVertex), (void*)offsetof(BakedVertex, color));
+        glEnableVertexAttribArray(6);
+
+        glBindVertexArray(0);
+    }
+
+    void draw(Shader& lightingShader)
+    {
+        if (indexCount == 0)
+            return;
+
+        lightingShader.use();
+        lightingShader.setBool("baked", true);
+        setModelMatrix(lightingShader, glm::mat4(1.0f));
+        lightingShader.setFloat("material.shininess", 32.0f);
+
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+
+        lightingShader.setBool("baked", false);
+    }
+
+    // draws only the listed cubes, indices in ascending order as FrustumCuller::visible
+    void draw(Shader& lightingShader, const std::vector<unsigned int>& visible)
+    {
+        if (visible.size() * cubeIndexCount == indexCount) {
+            draw(lightingShader);
+            return;
+        }
+        if (visible.empty())
+            return;
+
+        // merge neighbouring cubes into one range of the index buffer
+        counts.clear();
+        offsets.clear();
+        unsigned int runStart = visible[0], runEnd = visible[0] + 1;
+        for (size_t i = 1; i <= visible.size(); i++) {
+            if (i < visible.size() && visible[i] == runEnd) {
+                runEnd++;
+                continue;
+            }
+            counts.push_back((GLsizei)((runEnd - runStart) * cubeIndexCount));
+            offsets.push_back((const void*)((size_t)runStart * cubeIndexCount * sizeof(unsigned int)));
+            if (i < visible.size()) {
+                runStart = visible[i];
+                runEnd = runStart + 1;
+            }
+        }
+
+        lightingShader.use();
+        lightingShader.setBool("baked", true);
+        setModelMatrix(lightingShader, glm::mat4(1.0f));
+        lightingShader.setFloat("material.shininess", 32.0f);
+
+        glBindVertexArray(VAO);
+        glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)counts.size());
+
+        lightingShader.setBool("baked", false);
+    }
+
+    void release()
+    {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+        indexCount = 0;
+    }
+
+private:
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+};
+
+#endif /* staticmesh_h */
@@ -0,0 +1,142 @@
+#pragma once
+//
+//  uniformbuffers.h
+//  std140 uniform blocks shared by every program
+//
+//  The Camera and Lights blocks are bound once to fixed binding points and
+//  updated with one glBufferSubData each, instead of pushing the same
+//  uniforms into every program every frame. The structs below mirror the
+//  std140 layout of the blocks declared in the shaders.
+//
+
+#ifndef uniformbuffers_h
+#define uniformbuffers_h
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+// binding points shared by every program
+const GLuint CAMERA_BLOCK_BINDING = 0;
+const GLuint LIGHTS_BLOCK_BINDING = 1;
+const GLuint OBJECT_BLOCK_BINDING = 2;
+
+// must match NR_POINT_LIGHTS in vertexShaderForGouraudShading.vs
+const int MAX_POINT_LIGHTS = 2;
+
+// layout (std140) uniform Camera
+struct CameraBlock {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec3 viewPos;
+    float pad0;
+};
+
+struct PointLightData {
+    glm::vec3 position;
+    float k_c;
+    glm::vec3 ambient;
+    float k_l;
+    glm::vec3 diffuse;
+    float k_q;
+    glm::vec3 specular;
+    float pad0;
+    glm::vec3 emissive;
+    float pad1;
+};
+
+struct SpotLightData {
+    glm::vec3 position;
+    float cos_theta;
+    glm::vec3 direction;
+    float k_c;
+    glm::vec3 ambient;
+    float k_l;
+    glm::vec3 diffuse;
+    float k_q;
+    glm::vec3 specular;
+    float pad0;
+};
+
+struct DirectionalLightData {
+    glm::vec3 direction;
+    float pad0;
+    glm::vec3 ambient;
+    float pad1;
+    glm::vec3 diffuse;
+    float pad2;
+    glm::vec3 specular;
+    float pad3;
+};
+
+// layout (std140) uniform Lights, bools are 4 bytes in std140
+struct LightsBlock {
+    PointLightData pointLights[MAX_POINT_LIGHTS];
+    SpotLightData spotLight;
+    DirectionalLightData directionalLight;
+    int directionLightOn;
+    int spotLightOn;
+    int ambientLight;
+    int diffuseLight;
+    int specularLight;
+    int pad0[3];
+};
+
+// layout (std140) uniform Object, one per queued draw, written into the frame's ring buffer region
+struct ObjectBlock {
+    glm::mat4 model;
+    glm::vec4 normalMatrix[3];  // std140 mat3, one vec4 per column
+    glm::vec4 color;            // flat shaded programs
+    glm::vec3 ambient;          // lit programs, Material
+    float pad0;
+    glm::vec3 diffuse;
+    float pad1;
+    glm::vec3 specular;
+    float pad2;
+    glm::vec3 emissive;
+    float shininess;
+};
+
+static_assert(sizeof(CameraBlock) == 144, "CameraBlock does not match the std140 layout");
+static_assert(sizeof(PointLightData) == 80, "PointLightData does not match the std140 layout");
+static_assert(sizeof(SpotLightData) == 80, "SpotLightData does not match the std140 layout");
+static_assert(sizeof(DirectionalLightData) == 64, "DirectionalLightData does not match the std140 layout");
+static_assert(sizeof(ObjectBlock) == 192, "ObjectBlock does not match the std140 layout");
+
+class UniformBuffer {
+public:
+    unsigned int ID = 0;
+    GLsizeiptr size = 0;
+
+    void create(GLsizeiptr bufferSize, GLuint binding)
+    {
+        size = bufferSize;
+        glGenBuffers(1, &ID);
+        glBindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+    }
+
+    void update(const void* data, GLsizeiptr dataSize, GLintptr offset = 0)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, ID);
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+    }
+
+    void release()
+    {
+        glDeleteBuffers(1, &ID);
+        ID = 0;
+    }
+};
+
+// hooks a program up to the shared blocks, blocks it does not declare are skipped
+inline void bindSharedUniformBlocks(const Shader& shader)
+{
+    shader.bindUniformBlock("Camera", CAMERA_BLOCK_BINDING);
+    shader.bindUniformBlock("Lights", LIGHTS_BLOCK_BINDING);
+    shader.bindUniformBlock("Object", OBJECT_BLOCK_BINDING);
+}
+
+#endif /* uniformbuffers_h */
@@ -1,15 +1,35 @@
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-
-out vec4 color;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main()
-{
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
-    color = vec4(aColor, 1.0f);
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+out vec4 color;
+flat out vec4 objectColorOut;
+
+uniform mat4 model;
+
+//draws of the render queue read model and color from a range of the ring buffer,
+//the block is the leading part of the Object block of the lighting shader
+layout (std140) uniform Object {
+    mat4 objectModel;
+    mat3 objectNormalMatrix;
+    vec4 objectColor;
+};
+uniform bool dynamicObject = false;
+
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
+
+void main()
+{
+    mat4 M = model;
+    objectColorOut = vec4(0.0f);
+    if(dynamicObject){
+        M = objectModel;
+        objectColorOut = objectColor;
+    }
+    gl_Position = projection * view * M * vec4(aPos, 1.0f);
+    color = vec4(aColor, 1.0f);
 }
\ No newline at end of file
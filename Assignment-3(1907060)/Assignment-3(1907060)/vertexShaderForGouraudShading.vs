@@ -1,192 +1,308 @@
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-
-out vec4 LightingColor;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    vec3 emissive;
-    float shininess;
-};
-
-struct DirectionalLight {
-    vec3 direction;    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
-struct PointLight {
-    vec3 position;
-    
-    float k_c;      //attenuation factors
-    float k_l;      //attenuation factors
-    float k_q;      //attenuation factors
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    vec3 emissive;
-};
-
-struct SpotLight {
-    vec3 position;
-    vec3 direction;
-    
-    float cos_theta;
-    
-    float k_c;      //attenuation factors
-    float k_l;      //attenuation factors
-    float k_q;      //attenuation factors
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
-//other variables and instances needed
-#define NR_POINT_LIGHTS 2
-uniform bool ambientLight = true;
-uniform bool diffuseLight = true;
-uniform bool specularLight = true;
-uniform bool directionLightOn = true;
-uniform bool spotLightOn = false;
-uniform vec3 viewPos;
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-uniform Material material;
-uniform DirectionalLight directionalLight;
-uniform SpotLight spotLight;
-
-//function prototypes
-vec3 CalcPointLight(Material material, PointLight light, vec3 N, vec3 Pos, vec3 V);
-vec3 CalcDirectionalLight(Material material, DirectionalLight light, vec3 N, vec3 V);
-vec3 CalcSpotLight(Material material, SpotLight light, vec3 N, vec3 Pos, vec3 V);
-
-void main()
-{
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    
-    vec3 Pos = vec3(model * vec4(aPos, 1.0));
-    vec3 Normal = mat3(transpose(inverse(model))) * aNormal;
-    
-    //properties
-    vec3 N = normalize(Normal);
-    vec3 V = normalize(viewPos - Pos);
-
-    vec3 result = vec3(0.0f);
-    
-    //lights
-    for(int i = 0; i < NR_POINT_LIGHTS; i++){
-        result += CalcPointLight(material, pointLights[i], N, Pos, V);
-    }
-    if(directionLightOn){
-        result += CalcDirectionalLight(material, directionalLight, N, V);
-    }
-    if(spotLightOn){
-        result += CalcSpotLight(material, spotLight, N, Pos, V);
-    }
-    LightingColor = vec4(result, 1.0);    
-}
-
-//calculates the color when using a point light
-vec3 CalcPointLight(Material material, PointLight light, vec3 N, vec3 Pos, vec3 V)
-{
-    vec3 L = normalize(light.position - Pos);
-    vec3 R = reflect(-L, N);
-    
-    vec3 K_A = material.ambient;
-    vec3 K_D = material.diffuse;
-    vec3 K_S = material.specular;
-    vec3 emissive = material.emissive;
-    
-    // attenuation
-    float d = length(light.position - Pos);
-    float attenuation = 1/(light.k_c + light.k_l * d + light.k_q * (d * d));
-    
-    vec3 ambient = K_A * light.ambient;
-    vec3 diffuse = K_D * max(dot(N, L), 0.0) * light.diffuse;
-    vec3 specular = K_S * pow(max(dot(V, R), 0.0), material.shininess) * light.specular;
-    
-    ambient *= attenuation;
-    diffuse *= attenuation;
-    specular *= attenuation;
-    
-    return (ambient + diffuse + specular + emissive);
-}
-
-//calculates the color when using directional light
-vec3 CalcDirectionalLight(Material material, DirectionalLight light, vec3 N, vec3 V)
-{
-    vec3 L = normalize(-light.direction);
-    vec3 R = reflect(-L, N);
-    
-    vec3 K_A = material.ambient;
-    vec3 K_D = material.diffuse;
-    vec3 K_S = material.specular;
-
-    vec3 ambient, diffuse, specular;
-
-    if(ambientLight){
-        ambient = K_A * light.ambient;
-    }
-    else{
-        ambient = vec3(0.0f, 0.0f, 0.0f);
-    }
-
-    if(diffuseLight){
-        diffuse = K_D * max(dot(N, L), 0.0) * light.diffuse;
-    }
-    else{
-        diffuse = vec3(0.0f, 0.0f, 0.0f);
-    }
-
-    if(specularLight){
-        specular = K_S * pow(max(dot(V, R), 0.0), material.shininess) * light.specular;
-    }
-    else{
-        specular = vec3(0.0f, 0.0f, 0.0f);
-    }
-    
-    return (ambient + diffuse + specular);
-}
-
-//calculates the color when using spot light
-vec3 CalcSpotLight(Material material, SpotLight light, vec3 N, vec3 Pos, vec3 V)
-{
-    vec3 L = normalize(light.position - Pos);
-    vec3 R = reflect(-L, N);
-    
-    vec3 K_A = material.ambient;
-    vec3 K_D = material.diffuse;
-    vec3 K_S = material.specular;
-    
-    // attenuation
-    float d = length(light.position - Pos);
-    float attenuation = 1/(light.k_c + light.k_l * d + light.k_q * (d * d));
-    
-    vec3 ambient = K_A * light.ambient;
-    vec3 diffuse = K_D * max(dot(N, L), 0.0) * light.diffuse;
-    vec3 specular = K_S * pow(max(dot(V, R), 0.001), material.shininess) * light.specular;
-    
-    float cos_alpha = dot(L, normalize(-light.direction));
-    float intensity;
-    if(cos_alpha < light.cos_theta){
-        intensity = 0.0f;
-    }
-    else{
-        intensity = cos_alpha;
-    }
-
-    ambient *= attenuation * intensity;
-    diffuse *= attenuation * intensity;
-    specular *= attenuation * intensity;
-    
-    return (ambient + diffuse + specular);
-}
\ No newline at end of file
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in mat4 aModel;     //per-instance model matrix (locations 2-5)
+layout (location = 6) in vec3 aColor;     //per-instance or per-vertex (baked) material color
+layout (location = 7) in mat3 aNormalMatrix;  //per-instance normal matrix (locations 7-9)
+
+out vec4 LightingColor;
+
+uniform mat4 model;
+uniform mat3 normalMatrix;    //transpose(inverse(model)), computed once per draw on the CPU
+
+layout (std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+};
+
+struct Material {
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    vec3 emissive;
+    float shininess;
+};
+
+struct DirectionalLight {
+    vec3 direction;    
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+//light structs are laid out for std140, each float fills the padding after a vec3
+struct PointLight {
+    vec3 position;
+    float k_c;      //attenuation factors
+    vec3 ambient;
+    float k_l;      //attenuation factors
+    vec3 diffuse;
+    float k_q;      //attenuation factors
+    vec3 specular;
+    vec3 emissive;
+};
+
+struct SpotLight {
+    vec3 position;
+    float cos_theta;
+    vec3 direction;
+    float k_c;      //attenuation factors
+    vec3 ambient;
+    float k_l;      //attenuation factors
+    vec3 diffuse;
+    float k_q;      //attenuation factors
+    vec3 specular;
+};
+
+//other variables and instances needed
+//permutations are compiled with these defined (see shaderpermutations.h), otherwise the
+//switches fall back to the runtime flags of the Lights block
+#ifndef MAX_POINT_LIGHTS
+#define MAX_POINT_LIGHTS 2
+#endif
+#ifndef NR_POINT_LIGHTS
+#define NR_POINT_LIGHTS MAX_POINT_LIGHTS
+#endif
+#ifndef DIRECTIONAL_LIGHT
+#define DIRECTIONAL_LIGHT directionLightOn
+#endif
+#ifndef DIRECTIONAL_AMBIENT
+#define DIRECTIONAL_AMBIENT ambientLight
+#endif
+#ifndef DIRECTIONAL_DIFFUSE
+#define DIRECTIONAL_DIFFUSE diffuseLight
+#endif
+#ifndef DIRECTIONAL_SPECULAR
+#define DIRECTIONAL_SPECULAR specularLight
+#endif
+#ifndef SPOT_LIGHT
+#define SPOT_LIGHT spotLightOn
+#endif
+layout (std140) uniform Lights {
+    PointLight pointLights[MAX_POINT_LIGHTS];
+    SpotLight spotLight;
+    DirectionalLight directionalLight;
+    bool directionLightOn;
+    bool spotLightOn;
+    bool ambientLight;
+    bool diffuseLight;
+    bool specularLight;
+};
+uniform bool instanced = false;
+uniform bool baked = false;
+uniform Material material;
+
+//draws of the render queue read model, normal matrix and material from a range of the ring buffer
+layout (std140) uniform Object {
+    mat4 objectModel;
+    mat3 objectNormalMatrix;
+    vec4 objectColor;
+    Material objectMaterial;
+};
+uniform bool dynamicObject = false;
+
+//clustered forward lighting, see clusteredlights.h
+#ifdef CLUSTERED_LIGHTS
+uniform usamplerBuffer clusterGrid;     //offset and count into lightIndexList per cluster
+uniform usamplerBuffer lightIndexList;  //light indices grouped by cluster
+uniform samplerBuffer lightData;        //4 texels per light
+uniform vec4 clusterParams;             //tiles x, tiles y, depth slices, slice scale
+uniform float clusterNear;
+#endif
+
+//function prototypes
+vec3 CalcPointLight(Material material, PointLight light, vec3 N, vec3 Pos, vec3 V);
+vec3 CalcDirectionalLight(Material material, DirectionalLight light, vec3 N, vec3 V);
+vec3 CalcSpotLight(Material material, SpotLight light, vec3 N, vec3 Pos, vec3 V);
+#ifdef CLUSTERED_LIGHTS
+vec3 CalcClusteredPointLights(Material material, vec3 N, vec3 Pos, vec3 V, vec4 clipPos, float depth);
+#endif
+
+void main()
+{
+    //instanced draws take the model matrix and color from the instance buffer,
+    //baked vertices are already in world space and carry their own color
+    mat4 M = model;
+    mat3 NM = normalMatrix;
+    Material mat = material;
+    if(dynamicObject){
+        M = objectModel;
+        NM = objectNormalMatrix;
+        mat = objectMaterial;
+    }
+    if(instanced){
+        M = aModel;
+        NM = aNormalMatrix;
+    }
+    if(instanced || baked){
+        mat.ambient = aColor;
+        mat.diffuse = aColor;
+        mat.specular = aColor;
+        mat.emissive = vec3(0.0f);
+    }
+
+    gl_Position = projection * view * M * vec4(aPos, 1.0);
+    
+    vec3 Pos = vec3(M * vec4(aPos, 1.0));
+    vec3 Normal = NM * aNormal;
+    
+    //properties
+    vec3 N = normalize(Normal);
+    vec3 V = normalize(viewPos - Pos);
+
+    vec3 result = vec3(0.0f);
+    
+    //lights
+#ifdef CLUSTERED_LIGHTS
+    result += CalcClusteredPointLights(mat, N, Pos, V, gl_Position, -(view * vec4(Pos, 1.0)).z);
+#else
+    for(int i = 0; i < NR_POINT_LIGHTS; i++){
+        result += CalcPointLight(mat, pointLights[i], N, Pos, V);
+    }
+#endif
+    if(DIRECTIONAL_LIGHT){
+        result += CalcDirectionalLight(mat, directionalLight, N, V);
+    }
+    if(SPOT_LIGHT){
+        result += CalcSpotLight(mat, spotLight, N, Pos, V);
+    }
+    LightingColor = vec4(result, 1.0);    
+}
+
+//calculates the color when using a point light
+vec3 CalcPointLight(Material material, PointLight light, vec3 N, vec3 Pos, vec3 V)
+{
+    vec3 L = normalize(light.position - Pos);
+    vec3 R = reflect(-L, N);
+    
+    vec3 K_A = material.ambient;
+    vec3 K_D = material.diffuse;
+    vec3 K_S = material.specular;
+    vec3 emissive = material.emissive;
+    
+    // attenuation
+    float d = length(light.position - Pos);
+    float attenuation = 1/(light.k_c + light.k_l * d + light.k_q * (d * d));
+    
+    vec3 ambient = K_A * light.ambient;
+    vec3 diffuse = K_D * max(dot(N, L), 0.0) * light.diffuse;
+    vec3 specular = K_S * pow(max(dot(V, R), 0.0), material.shininess) * light.specular;
+    
+    ambient *= attenuation;
+    diffuse *= attenuation;
+    specular *= attenuation;
+    
+    return (ambient + diffuse + specular + emissive);
+}
+
+//calculates the color when using directional light
+vec3 CalcDirectionalLight(Material material, DirectionalLight light, vec3 N, vec3 V)
+{
+    vec3 L = normalize(-light.direction);
+    vec3 R = reflect(-L, N);
+    
+    vec3 K_A = material.ambient;
+    vec3 K_D = material.diffuse;
+    vec3 K_S = material.specular;
+
+    vec3 ambient, diffuse, specular;
+
+    if(DIRECTIONAL_AMBIENT){
+        ambient = K_A * light.ambient;
+    }
+    else{
+        ambient = vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    if(DIRECTIONAL_DIFFUSE){
+        diffuse = K_D * max(dot(N, L), 0.0) * light.diffuse;
+    }
+    else{
+        diffuse = vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    if(DIRECTIONAL_SPECULAR){
+        specular = K_S * pow(max(dot(V, R), 0.0), material.shininess) * light.specular;
+    }
+    else{
+        specular = vec3(0.0f, 0.0f, 0.0f);
+    }
+    
+    return (ambient + diffuse + specular);
+}
+
+//calculates the color when using spot light
+vec3 CalcSpotLight(Material material, SpotLight light, vec3 N, vec3 Pos, vec3 V)
+{
+    vec3 L = normalize(light.position - Pos);
+    vec3 R = reflect(-L, N);
+    
+    vec3 K_A = material.ambient;
+    vec3 K_D = material.diffuse;
+    vec3 K_S = material.specular;
+    
+    // attenuation
+    float d = length(light.position - Pos);
+    float attenuation = 1/(light.k_c + light.k_l * d + light.k_q * (d * d));
+    
+    vec3 ambient = K_A * light.ambient;
+    vec3 diffuse = K_D * max(dot(N, L), 0.0) * light.diffuse;
+    vec3 specular = K_S * pow(max(dot(V, R), 0.001), material.shininess) * light.specular;
+    
+    float cos_alpha = dot(L, normalize(-light.direction));
+    float intensity;
+    if(cos_alpha < light.cos_theta){
+        intensity = 0.0f;
+    }
+    else{
+        intensity = cos_alpha;
+    }
+
+    ambient *= attenuation * intensity;
+    diffuse *= attenuation * intensity;
+    specular *= attenuation * intensity;
+    
+    return (ambient + diffuse + specular);
+}
+
+#ifdef CLUSTERED_LIGHTS
+//calculates the color of every point light listed in the cluster of this vertex
+vec3 CalcClusteredPointLights(Material material, vec3 N, vec3 Pos, vec3 V, vec4 clipPos, float depth)
+{
+    ivec3 tiles = ivec3(clusterParams.xyz);
+    vec2 ndc = clipPos.xy / max(clipPos.w, 0.0001);
+    int x = clamp(int(floor((ndc.x * 0.5 + 0.5) * clusterParams.x)), 0, tiles.x - 1);
+    int y = clamp(int(floor((ndc.y * 0.5 + 0.5) * clusterParams.y)), 0, tiles.y - 1);
+    int z = 0;
+    if(depth > clusterNear){
+        z = clamp(int(floor(log(depth / clusterNear) * clusterParams.w)), 0, tiles.z - 1);
+    }
+    uvec2 cluster = texelFetch(clusterGrid, (z * tiles.y + y) * tiles.x + x).xy;
+
+    //the emissive term is added once, not once per light
+    Material lit = material;
+    lit.emissive = vec3(0.0f);
+
+    vec3 result = vec3(0.0f);
+    for(uint i = 0u; i < cluster.y; i++){
+        int index = int(texelFetch(lightIndexList, int(cluster.x + i)).r);
+        vec4 t0 = texelFetch(lightData, index * 4);
+        vec4 t1 = texelFetch(lightData, index * 4 + 1);
+        vec4 t2 = texelFetch(lightData, index * 4 + 2);
+        vec4 t3 = texelFetch(lightData, index * 4 + 3);
+
+        PointLight light;
+        light.position = t0.xyz;
+        light.k_c = t0.w;
+        light.ambient = t1.xyz;
+        light.k_l = t1.w;
+        light.diffuse = t2.xyz;
+        light.k_q = t2.w;
+        light.specular = t3.xyz;
+        light.emissive = vec3(0.0f);
+        result += CalcPointLight(lit, light, N, Pos, V);
+    }
+    return result + material.emissive;
+}
+#endif
\ No newline at end of file
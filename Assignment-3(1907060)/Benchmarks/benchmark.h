@@ -0,0 +1,93 @@
+#pragma once
+//
+//  benchmark.h
+//  Minimal timing harness for the microbenchmarks
+//
+//  Each case runs its body several times and keeps the fastest run, which
+//  filters out scheduler noise and the first-touch page faults of the
+//  output buffers. Results are printed as nanoseconds and heap allocations
+//  per item; main.cpp replaces the global operator new to count the
+//  allocations.
+//
+
+#ifndef benchmark_h
+#define benchmark_h
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "../Assignment-3(1907060)/camera.h"
+
+// written by the benchmarks so the compiler cannot drop the measured work
+inline volatile float benchmarkSink = 0.0f;
+
+// calls of the global operator new since the start, from any thread; the
+// job workers allocate too, and parallelFor() returning orders their counts
+// before the read after body()
+inline std::atomic<size_t> allocationCount{ 0 };
+
+struct Measurement {
+    double nanoseconds;     // per item, of the fastest run
+    double allocations;     // per item, of the run with the fewest
+};
+
+// fastest of repeats runs of body()
+template <typename Body>
+Measurement measure(size_t items, int repeats, Body body)
+{
+    double best = 1e300;
+    size_t fewestAllocations = (size_t)-1;
+    for (int run = 0; run < repeats; run++) {
+        size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        fewestAllocations = std::min(fewestAllocations, allocationCount.load(std::memory_order_relaxed) - allocationsBefore);
+    }
+    return { best / (double)items, (double)fewestAllocations / (double)items };
+}
+
+// enough runs for about 20 million items in total, at least 5
+inline int repeatsFor(size_t items)
+{
+    return (int)std::max<size_t>(5, 20000000 / std::max<size_t>(items, 1));
+}
+
+// 1, 2, 4, ... and maxThreads itself, for the cases that run on the job system
+inline std::vector<unsigned int> threadCounts(unsigned int maxThreads)
+{
+    std::vector<unsigned int> counts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(std::max(maxThreads, 1u));
+    return counts;
+}
+
+// projection * view of the camera main.cpp starts with, at its 800x600 window size and near/far planes
+inline glm::mat4 startCameraViewProjection()
+{
+    Camera camera(glm::vec3(1.5f, 3.8f, 10.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f);
+    return projection * camera.GetViewMatrix();
+}
+
+inline void printHeader(const char* title)
+{
+    std::printf("\n%s\n%-36s %10s %12s %12s %9s\n", title, "case", "items", "ns/item", "allocs/item", "speedup");
+}
+
+// speedup against baseline nanoseconds per item
+inline void printResult(const char* name, size_t items, const Measurement& result, double baseline)
+{
+    std::printf("%-36s %10zu %12.2f %12.2f %8.2fx\n", name, items, result.nanoseconds, result.allocations, baseline / result.nanoseconds);
+}
+
+#endif /* benchmark_h */
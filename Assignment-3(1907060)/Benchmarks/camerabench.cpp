@@ -0,0 +1,59 @@
+//
+//  camerabench.cpp
+//  The per-frame camera and light updates, no GL context needed
+//
+
+#include <glm/glm.hpp>
+
+#include "benchmark.h"
+#include "../Assignment-3(1907060)/camera.h"
+#include "../Assignment-3(1907060)/basic_camera.h"
+#include "../Assignment-3(1907060)/pointlight.h"
+
+void cameraBenchmarks()
+{
+    const size_t count = 1000000;
+    int repeats = repeatsFor(count);
+    printHeader("camera and lights");
+
+    Camera camera(glm::vec3(1.5f, 3.8f, 10.0f));
+    // ProcessMouseMovement() is the public way into the private updateCameraVectors()
+    Measurement update = measure(count, repeats, [&]() {
+        for (size_t i = 0; i < count; i++)
+            camera.ProcessMouseMovement((i & 1) ? 0.5f : -0.5f, 0.25f);
+    });
+    benchmarkSink = benchmarkSink + camera.Front.x;
+    printResult("Camera::updateCameraVectors", count, update, update.nanoseconds);
+
+    Measurement view = measure(count, repeats, [&]() {
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; i++) {
+            camera.Position.x = (float)(i & 255);
+            sum += camera.GetViewMatrix()[3][0];
+        }
+        benchmarkSink = benchmarkSink + sum;
+    });
+    printResult("Camera::GetViewMatrix", count, view, view.nanoseconds);
+
+    BasicCamera basicCamera(1.5f, 3.8f, 10.0f, 4.0f, 4.0f, 6.0f);
+    Measurement basicView = measure(count, repeats, [&]() {
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; i++) {
+            basicCamera.eye.x = (float)(i & 255);
+            sum += basicCamera.createViewMatrix()[3][0];
+        }
+        benchmarkSink = benchmarkSink + sum;
+    });
+    printResult("BasicCamera::createViewMatrix", count, basicView, view.nanoseconds);
+
+    PointLight light(2.0f, 3.0f, 2.0f, 0.2f, 0.2f, 0.2f, 0.8f, 0.8f, 0.8f, 1.0f, 1.0f, 1.0f, 1.0f, 0.09f, 0.032f, 1);
+    LightsBlock block = {};
+    Measurement pointLight = measure(count, repeats, [&]() {
+        for (size_t i = 0; i < count; i++) {
+            light.position.x = (float)(i & 255);
+            light.setUpPointLight(block.pointLights[i % MAX_POINT_LIGHTS]);
+        }
+    });
+    benchmarkSink = benchmarkSink + block.pointLights[0].position.x;
+    printResult("PointLight::setUpPointLight", count, pointLight, pointLight.nanoseconds);
+}
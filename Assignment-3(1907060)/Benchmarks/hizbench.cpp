@@ -0,0 +1,88 @@
+//
+//  hizbench.cpp
+//  HiZCuller on its own: rasterizing the occluders and testing boxes
+//  against the pyramid, once per thread count
+//
+//  The occluders come from a scene file, kitchen.scene in this directory
+//  unless --scene names another; export the kitchen with
+//      Assignment-3(1907060) --export-scene ../Benchmarks/kitchen.scene
+//  Without the file only the floor, ceiling and the two walls of the
+//  kitchen are used. The tested boxes are small random cubes inside the
+//  kitchen and behind its back wall, seen from the kitchen's start camera.
+//
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "../Assignment-3(1907060)/batchtransform.h"
+#include "../Assignment-3(1907060)/hizculler.h"
+#include "../Assignment-3(1907060)/scenefile.h"
+
+// the shell of the kitchen as drawStaticScene() places it
+static void addRoomShell(FrustumCuller& boxes)
+{
+    const glm::vec3 shell[4][2] = {
+        { glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(6.0f, 0.1f, 6.0f) },       // floor
+        { glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(6.0f, 0.1f, 6.0f) },       // ceiling
+        { glm::vec3(0.0f, 0.1f, -0.05f), glm::vec3(6.0f, 5.0f, 0.1f) },     // back wall
+        { glm::vec3(-0.05f, 0.1f, 0.0f), glm::vec3(0.1f, 5.0f, 6.0f) }      // left wall
+    };
+    for (const auto& box : shell)
+        boxes.addCube(composeTransform(glm::mat4(1.0f), box[0], glm::vec3(0.0f), box[1]));
+}
+
+void hizBenchmarks(const char* scenePath, unsigned int maxThreads)
+{
+    FrustumCuller boxes;
+    SceneFile scene;
+    if (scene.open(scenePath)) {
+        scene.forEachCube(glm::mat4(1.0f), [&](const glm::mat4& model, const SceneMaterial&) {
+            boxes.addCube(model);
+        });
+    }
+    else {
+        addRoomShell(boxes);
+    }
+    std::string title = std::string("hi-z culler, occluders from ") + (scene.isOpen() ? scenePath : "the room shell");
+    printHeader(title.c_str());
+
+    // half of the boxes in the room, half behind the back wall
+    const size_t count = 100000;
+    std::mt19937 random(1907060);
+    std::uniform_real_distribution<float> x(0.2f, 5.8f), y(0.2f, 4.8f), z(-6.0f, 5.8f), size(0.05f, 0.3f);
+    std::vector<unsigned int> candidates;
+    candidates.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        float half = size(random);
+        candidates.push_back(boxes.addBox(glm::vec3(x(random), y(random), z(random)), glm::vec3(half)));
+    }
+
+    glm::mat4 viewProjection = startCameraViewProjection();
+
+    HiZCuller culler;
+    culler.selectOccluders(boxes);
+    std::vector<unsigned int> visible;
+    double rasterBaseline = 0.0, testBaseline = 0.0;
+    for (unsigned int threads : threadCounts(maxThreads)) {
+        jobs.start(threads);
+
+        Measurement raster = measure(1, 50, [&]() { culler.render(boxes, viewProjection); });
+        Measurement test = measure(count, 20, [&]() { culler.test(candidates, boxes, viewProjection, visible); });
+        if (threads == 1) {
+            rasterBaseline = raster.nanoseconds;
+            testBaseline = test.nanoseconds;
+        }
+
+        std::string rasterName = "raster " + std::to_string(culler.stats.triangles) + " tris, threads " + std::to_string(threads);
+        std::string testName = "test boxes, threads " + std::to_string(threads);
+        printResult(rasterName.c_str(), 1, raster, rasterBaseline);
+        printResult(testName.c_str(), count, test, testBaseline);
+    }
+    jobs.stop();
+    std::printf("%u of %zu boxes culled behind %u occluders\n", culler.stats.culled, count, culler.stats.occluders);
+}
@@ -0,0 +1,66 @@
+//
+//  main.cpp
+//  Microbenchmarks of the renderer's CPU-side building blocks
+//
+//  Build in Release; the x64 configurations enable AVX2 like the app's, so
+//  the SIMD paths measured are the ones the app runs. Run from this directory, the shader cases load
+//  the kitchen's shader files from ../Assignment-3(1907060).
+//
+//  --threads N runs the threaded cases with 1, 2, 4, ... up to N threads,
+//  one per hardware thread by default
+//  --scene file takes the hi-z occluders and the replicated room from a
+//  scene file, kitchen.scene by default
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "benchmark.h"
+
+// every heap allocation of the process passes here and is counted for the allocs/item column
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size > 0 ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void transformBenchmarks();
+void cameraBenchmarks();
+void shaderBenchmarks();
+void hizBenchmarks(const char* scenePath, unsigned int maxThreads);
+void sceneBenchmarks(const char* scenePath, unsigned int maxThreads);
+
+int main(int argc, char** argv)
+{
+    unsigned int maxThreads = std::thread::hardware_concurrency();
+    const char* scenePath = "kitchen.scene";
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--threads") == 0)
+            maxThreads = (unsigned int)std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--scene") == 0)
+            scenePath = argv[i + 1];
+    }
+    if (maxThreads == 0)
+        maxThreads = 1;
+
+    transformBenchmarks();
+    cameraBenchmarks();
+    shaderBenchmarks();
+    hizBenchmarks(scenePath, maxThreads);
+    sceneBenchmarks(scenePath, maxThreads);
+    return 0;
+}
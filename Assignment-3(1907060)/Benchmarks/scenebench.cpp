@@ -0,0 +1,82 @@
+//
+//  scenebench.cpp
+//  Frame preparation of a replicated scene on the job system, once per
+//  thread count
+//
+//  The kitchen from kitchen.scene (see hizbench.cpp) is repeated on a
+//  29x29 room grid, about 100,000 cubes, as --rooms 29 does. Measured are
+//  the parts drawRooms() and the static culling run every frame: the model
+//  matrices of every cube of every room, then the frustum test of all of
+//  them from the kitchen's start camera. Without the scene file the rooms
+//  hold 119 random cubes, as many as the kitchen.
+//
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "../Assignment-3(1907060)/frustumculler.h"
+#include "../Assignment-3(1907060)/scenefile.h"
+
+void sceneBenchmarks(const char* scenePath, unsigned int maxThreads)
+{
+    SceneFile scene;
+    SceneWriter randomRoom;
+    SceneArrays cubes;
+    if (scene.open(scenePath)) {
+        cubes = scene.arrays();
+    }
+    else {
+        std::mt19937 random(1907060);
+        std::uniform_real_distribution<float> x(0.0f, 5.5f), y(0.0f, 4.5f), size(0.05f, 1.5f);
+        for (int i = 0; i < 119; i++)
+            randomRoom.add(glm::vec3(x(random), y(random), x(random)), glm::vec3(0.0f), glm::vec3(size(random), size(random), size(random)), glm::vec3(0.5f));
+        cubes = randomRoom.arrays();
+    }
+
+    const int ROOM_GRID = 29;
+    const float ROOM_SPACING = 7.0f;
+    std::vector<glm::mat4> roomMatrices;
+    for (int x = 0; x < ROOM_GRID; x++)
+        for (int z = 0; z < ROOM_GRID; z++)
+            roomMatrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * ROOM_SPACING, 0.0f, z * ROOM_SPACING)));
+    size_t count = cubes.count * roomMatrices.size();
+
+    std::string title = "scene preparation, " + std::to_string(count) + " cubes from " + (scene.isOpen() ? scenePath : "random rooms");
+    printHeader(title.c_str());
+
+    Frustum frustum = extractFrustum(startCameraViewProjection());
+
+    std::vector<glm::mat4> models;
+    FrustumCuller culler;
+    composeSceneCubes(cubes, roomMatrices.data(), roomMatrices.size(), models);
+    culler.reserve(count);
+    for (const glm::mat4& model : models)
+        culler.addCube(model);
+
+    double composeBaseline = 0.0, cullBaseline = 0.0;
+    for (unsigned int threads : threadCounts(maxThreads)) {
+        jobs.start(threads);
+
+        Measurement compose = measure(count, 20, [&]() {
+            composeSceneCubes(cubes, roomMatrices.data(), roomMatrices.size(), models);
+        });
+        benchmarkSink = benchmarkSink + models[count / 2][3][0];
+        Measurement cull = measure(count, 20, [&]() { culler.cull(frustum); });
+        if (threads == 1) {
+            composeBaseline = compose.nanoseconds;
+            cullBaseline = cull.nanoseconds;
+        }
+
+        std::string composeName = "composeSceneCubes, threads " + std::to_string(threads);
+        std::string cullName = "FrustumCuller::cull, threads " + std::to_string(threads);
+        printResult(composeName.c_str(), count, compose, composeBaseline);
+        printResult(cullName.c_str(), count, cull, cullBaseline);
+    }
+    jobs.stop();
+    std::printf("%zu of %zu cubes inside the frustum\n", culler.visible.size(), count);
+}
@@ -0,0 +1,118 @@
+//
+//  shaderbench.cpp
+//  Uniform updates through Shader, against a glGetUniformLocation per call
+//
+//  Needs a GL context; it comes from a hidden GLFW window, which still
+//  needs a display server (X11 or Wayland; Xvfb on a headless machine,
+//  where Mesa renders it on llvmpipe). Without one glfwInit() fails and
+//  the cases are skipped.
+//
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+#include "benchmark.h"
+#include "../Assignment-3(1907060)/shaderpermutations.h"
+
+static GLFWwindow* createHiddenContext()
+{
+    if (!glfwInit())
+        return nullptr;
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    GLFWwindow* window = glfwCreateWindow(64, 64, "Benchmarks", NULL, NULL);
+    if (window == NULL)
+        return nullptr;
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        glfwDestroyWindow(window);
+        return nullptr;
+    }
+    loadGLExtensions((GLExtLoadProc)glfwGetProcAddress);
+    return window;
+}
+
+void shaderBenchmarks()
+{
+    printHeader("shader uniforms (GL)");
+    GLFWwindow* window = createHiddenContext();
+    if (window == nullptr) {
+        std::printf("skipped, no OpenGL context\n");
+        glfwTerminate();
+        return;
+    }
+
+    {
+        // the lighting program of the kitchen, run from the Benchmarks directory
+        ShaderPermutations lightingShaders("../Assignment-3(1907060)/vertexShaderForGouraudShading.vs", "../Assignment-3(1907060)/fragmentShaderForGouraudShading.fs");
+        Shader& shader = lightingShaders.get(FEATURE_DIRECTIONAL_LIGHT | FEATURE_SPOT_LIGHT, MAX_POINT_LIGHTS);
+        shader.use();
+
+        const size_t count = 100000;
+        const int repeats = 20;
+        glm::mat4 model(1.0f);
+        glm::vec3 color(0.5f, 0.25f, 0.125f);
+
+        Measurement lookupMat4 = measure(count, repeats, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                model[3][0] = (float)(i & 255);
+                glUniformMatrix4fv(glGetUniformLocation(shader.ID, "model"), 1, GL_FALSE, &model[0][0]);
+            }
+        });
+        printResult("glGetUniformLocation + mat4", count, lookupMat4, lookupMat4.nanoseconds);
+
+        Measurement namedMat4 = measure(count, repeats, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                model[3][0] = (float)(i & 255);
+                shader.setMat4("model", model);
+            }
+        });
+        printResult("Shader::setMat4 by name", count, namedMat4, lookupMat4.nanoseconds);
+
+        GLint modelLocation = shader.uniformLocation("model");
+        Measurement locatedMat4 = measure(count, repeats, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                model[3][0] = (float)(i & 255);
+                shader.setMat4(modelLocation, model);
+            }
+        });
+        printResult("Shader::setMat4 by location", count, locatedMat4, lookupMat4.nanoseconds);
+
+        Measurement lookupVec3 = measure(count, repeats, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                color.x = (float)(i & 255);
+                glUniform3fv(glGetUniformLocation(shader.ID, "material.diffuse"), 1, &color[0]);
+            }
+        });
+        printResult("glGetUniformLocation + vec3", count, lookupVec3, lookupVec3.nanoseconds);
+
+        Measurement namedVec3 = measure(count, repeats, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                color.x = (float)(i & 255);
+                shader.setVec3("material.diffuse", color);
+            }
+        });
+        printResult("Shader::setVec3 by name", count, namedVec3, lookupVec3.nanoseconds);
+
+        GLint diffuseLocation = shader.uniformLocation("material.diffuse");
+        Measurement locatedVec3 = measure(count, repeats, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                color.x = (float)(i & 255);
+                shader.setVec3(diffuseLocation, color);
+            }
+        });
+        printResult("Shader::setVec3 by location", count, locatedVec3, lookupVec3.nanoseconds);
+
+        lightingShaders.release();
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
@@ -0,0 +1,94 @@
+//
+//  transformbench.cpp
+//  composeTransform() and composeTransforms() against the per-call glm
+//  chain drawCube() used
+//
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+#include <vector>
+
+#include "benchmark.h"
+#include "../Assignment-3(1907060)/batchtransform.h"
+
+// the five chained glm calls drawCube() made for every cube
+static glm::mat4 perCallTransform(const glm::mat4& parent, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+    glm::mat4 translateMatrix = glm::translate(parent, position);
+    glm::mat4 rotateXMatrix = glm::rotate(translateMatrix, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::mat4 rotateYMatrix = glm::rotate(rotateXMatrix, glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 rotateZMatrix = glm::rotate(rotateYMatrix, glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    return glm::scale(rotateZMatrix, scale);
+}
+
+static float checksum(const std::vector<glm::mat4>& models)
+{
+    float sum = 0.0f;
+    for (size_t i = 0; i < models.size(); i += 97)
+        sum += models[i][3][0] + models[i][0][0];
+    return sum;
+}
+
+static void runCase(const char* label, size_t count, bool rotated)
+{
+    std::mt19937 random(1907060);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> size(0.05f, 6.0f);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+
+    std::vector<glm::vec3> positions(count), rotations(count, glm::vec3(0.0f)), scales(count);
+    for (size_t i = 0; i < count; i++) {
+        positions[i] = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+        scales[i] = glm::vec3(size(random), size(random), size(random));
+        if (rotated)
+            rotations[i] = glm::vec3(angle(random), angle(random), angle(random));
+    }
+
+    glm::mat4 parent = glm::translate(glm::mat4(1.0f), glm::vec3(7.0f, 0.0f, 14.0f));
+    std::vector<glm::mat4> models(count);
+    int repeats = repeatsFor(count);
+
+    Measurement perCall = measure(count, repeats, [&]() {
+        for (size_t i = 0; i < count; i++)
+            models[i] = perCallTransform(parent, positions[i], rotations[i], scales[i]);
+    });
+    benchmarkSink = benchmarkSink + checksum(models);
+
+    // what drawCube() does now, one object per call
+    Measurement single = measure(count, repeats, [&]() {
+        for (size_t i = 0; i < count; i++)
+            models[i] = composeTransform(parent, positions[i], rotations[i], scales[i]);
+    });
+    benchmarkSink = benchmarkSink + checksum(models);
+
+    Measurement batched = measure(count, repeats, [&]() {
+        composeTransforms(parent, positions.data(), rotations.data(), scales.data(), count, models.data());
+    });
+    benchmarkSink = benchmarkSink + checksum(models);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "glm per call, %s", label);
+    printResult(name, count, perCall, perCall.nanoseconds);
+    std::snprintf(name, sizeof(name), "composeTransform, %s", label);
+    printResult(name, count, single, perCall.nanoseconds);
+    std::snprintf(name, sizeof(name), "composeTransforms, %s", label);
+    printResult(name, count, batched, perCall.nanoseconds);
+}
+
+void transformBenchmarks()
+{
+#if defined(BATCH_TRANSFORM_AVX2)
+    printHeader("model matrices (AVX2)");
+#elif defined(BATCH_TRANSFORM_SSE)
+    printHeader("model matrices (SSE)");
+#else
+    printHeader("model matrices (scalar)");
+#endif
+    const size_t counts[] = { 1000, 100000, 1000000 };
+    for (size_t count : counts)
+        runCase("no rotation", count, false);
+    for (size_t count : counts)
+        runCase("rotated", count, true);
+}